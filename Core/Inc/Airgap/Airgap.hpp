@@ -5,22 +5,19 @@
 #include "AirgapShared.hpp"
 #include "ST-LIB_LOW/Sensors/LinearSensor/LinearSensor.hpp"
 #include "HALAL/Services/ADC/NewADC.hpp"
+#include "Common/Placement.hpp"
 
-class Airgap : public AirgapBase {
-    // MovingAverage<10> airgap_moving_avg;
-    LinearSensor<volatile float> airgap_sensor;
+// Sensor as in LPU: LinearSensor on target, a mock in the host benchmarks
+template <typename Sensor> class BasicAirgap : public AirgapBase {
+    // Single samples, filtered with the other channels (Filters/SensorFilters.hpp)
+    Sensor airgap_sensor;
 
 public:
-    Airgap(ST_LIB::ADCDomain::Instance& airgap_instance, float airgap_offset, float airgap_slope)
-        : airgap_sensor(
-              airgap_instance,
-              airgap_slope,
-              airgap_offset,
-              &airgap_v /*,
-              airgap_moving_avg*/
-          ) {}
+    template <typename ADCInstance>
+    BasicAirgap(ADCInstance& airgap_instance, float airgap_offset, float airgap_slope)
+        : airgap_sensor(airgap_instance, airgap_slope, airgap_offset, &airgap_v) {}
 
-    void update() { airgap_sensor.read(); }
+    ITCM_CODE void update() { airgap_sensor.read(); }
 
     void zeroing() {
         double airgap_sum = 0.0;
@@ -35,6 +32,8 @@ public:
     }
 };
 
+using Airgap = BasicAirgap<LinearSensor<volatile float>>;
+
 template <typename AirgapTuple> class AirgapArray;
 
 template <typename... AirgapInstances>
@@ -51,7 +50,7 @@ public:
             std::apply([](auto&... instance) { return std::make_tuple(&instance...); }, _instances);
     }
 
-    void update() {
+    ITCM_CODE void update() {
         std::apply([](auto*... instance) { (instance->update(), ...); }, airgap_instances);
     }
 
@@ -59,9 +58,15 @@ public:
         std::apply([](auto*... instance) { (instance->zeroing(), ...); }, airgap_instances);
     }
 
+    static constexpr size_t size() { return AirgapCount; }
+
     template <size_t Index> auto& get_airgap() {
         return *std::get<Index>(airgap_instances);
     }
+
+    template <typename Func> void for_each(Func&& func) {
+        std::apply([&](auto*... instance) { (func(*instance), ...); }, airgap_instances);
+    }
 };
 
 #endif // AIRGAP_HPP
@@ -1,17 +1,51 @@
 import argparse
+import hashlib
+import json
+import os
+from pathlib import Path
 from Packet_generation.Packet_generation import (
     Generate_PacketDescription,
     Generate_DataPackets_hpp,
     Generate_OrderPackets_hpp,
+    Generate_HostCodec_hpp,
+    Generate_forwarding_hpp,
+    board_header_path,
+    host_codec_file,
+    file_hash,
+    write_if_changed,
 )
 
+GENERATED_HEADERS = ("DataPackets.hpp", "OrderPackets.hpp")
+
 
 def parse_args():
     parser = argparse.ArgumentParser(description="Generate packet headers from JSON_ADE")
     parser.add_argument("board", help="Board key from Core/Inc/Code_generation/JSON_ADE/boards.json")
+    parser.add_argument("--force", action="store_true", help="Regenerate even if the inputs did not change")
     return parser.parse_args()
 
 
+def inputs_hash(json_path: str, board: str):
+    # Everything that can change the rendered headers: the schema, the generator and its templates
+    generator_dir = Path(__file__).resolve().parent
+    inputs = sorted(Path(json_path).rglob("*.json"))
+    inputs += sorted((generator_dir / "Packet_generation").glob("*.py"))
+    inputs += sorted((generator_dir / "Packet_generation").glob("*.hpp"))
+    inputs.append(Path(__file__).resolve())
+
+    digest = hashlib.sha256(board.encode())
+    for path in inputs:
+        digest.update(path.name.encode())
+        digest.update(path.read_bytes())
+    return digest.hexdigest()
+
+
+def outputs_hash(board: str):
+    outputs = {header: file_hash(board_header_path(board, header)) for header in GENERATED_HEADERS}
+    outputs["PacketCodec.hpp"] = file_hash(host_codec_file(board))
+    return outputs
+
+
 def main():
     args = parse_args()
     json_path = "Core/Inc/Code_generation/JSON_ADE"
@@ -19,9 +53,33 @@ def main():
     if not board:
         raise SystemExit("Board name cannot be empty")
 
-    Generate_PacketDescription(json_path, board)
-    Generate_DataPackets_hpp(board)
-    Generate_OrderPackets_hpp(board)
+    manifest_path = board_header_path(board, "generation.json")
+    manifest = {}
+    if os.path.exists(manifest_path):
+        with open(manifest_path) as f:
+            manifest = json.load(f)
+
+    current_inputs = inputs_hash(json_path, board)
+    up_to_date = (
+        not args.force
+        and manifest.get("inputs") == current_inputs
+        and manifest.get("outputs") == outputs_hash(board)
+    )
+
+    if up_to_date:
+        print(f"Packets for {board} are up to date")
+    else:
+        Generate_PacketDescription(json_path, board)
+        Generate_DataPackets_hpp(board)
+        Generate_OrderPackets_hpp(board)
+        Generate_HostCodec_hpp(board)
+        write_if_changed(
+            manifest_path,
+            json.dumps({"inputs": current_inputs, "outputs": outputs_hash(board)}, indent=2) + "\n",
+        )
+
+    for header in GENERATED_HEADERS:
+        Generate_forwarding_hpp(board, header)
 
 
 if __name__ == "__main__":
@@ -1,5 +1,10 @@
 #pragma once
 #include "ST-LIB.hpp"
+#include <bit>
+#include <cstring>
+#include <iterator>
+#include "Communications/PacketBatch.hpp"
+#include "Communications/StaticSlot.hpp"
 
 /*Data packets for {{board}}
 -AUTOGENERATED CODE, DO NOT MODIFY-*/
@@ -14,21 +19,82 @@ public:
     };
     {% endfor %}
 
+    {% for packet in packets -%}
+    {% if packet.fixed_size -%}
+    // Wire layout of {{packet.name}}: id followed by the fields, no padding
+    struct [[gnu::packed]] {{packet.name}}_wire_t {
+        uint16_t packet_id;
+        {%- for variable in packet.variables %}
+        {{variable.wire_type}} {{variable.name}};
+        {%- endfor %}
+    };
+    // {{packet.wire_size}} bytes: the size the generator computed from the JSON_ADE types
+    static_assert(sizeof({{packet.name}}_wire_t) == {{packet.wire_size}}, "{{packet.name}} wire size mismatch");
+
+    // The id and the wire buffer are the StackPacket's own; it stores no field
+    // pointers, so build() reads the bound variables through the ones kept here
+    class {{packet.name}}_packet_t final : public StackPacket<{{packet.wire_size}}> {
+    public:
+        static constexpr size_t WIRE_SIZE = {{packet.wire_size}};
+
+        {{packet.name}}_packet_t(uint16_t id{% for variable in packet.variables %}, {{variable.type}} *{{variable.name}}{% endfor %})
+            : StackPacket<WIRE_SIZE>(id){% for variable in packet.variables %}, {{variable.name}}_ptr({{variable.name}}){% endfor %} {}
+
+        static constexpr std::array<uint8_t, WIRE_SIZE> serialize(const {{packet.name}}_wire_t &wire) {
+            return std::bit_cast<std::array<uint8_t, WIRE_SIZE>>(wire);
+        }
+
+        // Straight-line field copies into the packed layout, no per-field dispatch
+        uint8_t *build() override {
+            auto bytes = serialize({this->id{% for variable in packet.variables %}, *{{variable.name}}_ptr{% endfor %}});
+            std::memcpy(std::data(this->buffer), bytes.data(), WIRE_SIZE);
+            return std::data(this->buffer);
+        }
+    {%- if packet.variables %}
+
+    private:
+        {%- for variable in packet.variables %}
+        {{variable.type}} *{{variable.name}}_ptr;
+        {%- endfor %}
+    {%- endif %}
+    };
+    {% else -%}
+    using {{packet.name}}_packet_t = HeapPacket;
+    {% endif %}
+    {% endfor %}
+    {% for batch in batches -%}
+    using {{batch.name}}_t = PacketBatch<{% for name in batch.packets %}{{name}}_packet_t{% if not loop.last %}, {% endif %}{% endfor %}>;
+    {% endfor %}
+
     {% for packet in packets -%}
     static void {{packet.name}}_init({% for variable in packet.variables %}{{variable.type}} &{{variable.name}}{% if not loop.last %}, {% endif %}{% endfor %})
     {
-        {{packet.name}}_packet = new HeapPacket(static_cast<uint16_t>({{packet.id}}){% if packet.variables %}, {% for variable in packet.variables %}&{{variable.name}}{% if not loop.last %}, {% endif %}{% endfor %}{% endif %});
+        {{packet.name}}_packet = {{packet.name}}_slot.emplace(static_cast<uint16_t>({{packet.id}}){% if packet.variables %}, {% for variable in packet.variables %}&{{variable.name}}{% if not loop.last %}, {% endif %}{% endfor %}{% endif %});
     }
 
     {% endfor -%}
 
 public:
     {%for packet in packets -%}
-    inline static HeapPacket *{{packet.name}}_packet{nullptr};
+    inline static {{packet.name}}_packet_t *{{packet.name}}_packet{nullptr};
     {% endfor %}
     {% for socket in DatagramSockets -%}
     inline static {{socket.type}} *{{socket.name}}{nullptr};
     {% endfor %}
+    {% for batch in batches -%}
+    inline static {{batch.name}}_t *{{batch.name}}{nullptr};
+    {% endfor %}
+
+    // Static storage: no heap allocation, sizes visible in the map file
+    {%for packet in packets -%}
+    constinit inline static StaticSlot<{{packet.name}}_packet_t> {{packet.name}}_slot{};
+    {% endfor %}
+    {% for socket in DatagramSockets -%}
+    constinit inline static StaticSlot<{{socket.type}}> {{socket.name}}_slot{};
+    {% endfor %}
+    {% for batch in batches -%}
+    constinit inline static StaticSlot<{{batch.name}}_t> {{batch.name}}_slot{};
+    {% endfor %}
 
     static void start()
     {
@@ -39,7 +105,10 @@ public:
         {% endfor %}
 
         {% for socket in DatagramSockets -%}
-        {{socket.name}} = new DatagramSocket("{{socket.board_ip}}",{{socket.port}},"{{socket.remote_ip}}",{{socket.port}});
+        {{socket.name}} = {{socket.name}}_slot.emplace("{{socket.board_ip}}",{{socket.port}},"{{socket.remote_ip}}",{{socket.port}});
+        {% endfor %}
+        {% for batch in batches -%}
+        {{batch.name}} = {{batch.name}}_slot.emplace({% for name in batch.packets %}{{name}}_packet{% if not loop.last %}, {% endif %}{% endfor %});
         {% endfor %}
 
         {%- for group in sending_packets %}
@@ -47,6 +116,9 @@ public:
             {% for packet in group.packets -%}
             DataPackets::{{packet.socket}}->send_packet(*DataPackets::{{packet.name}}_packet);
             {% endfor -%}
+            {% for batch in group.batches -%}
+            DataPackets::{{batch.socket}}->send_packet(*DataPackets::{{batch.name}});
+            {% endfor -%}
         });
         {%- endfor %}
     }
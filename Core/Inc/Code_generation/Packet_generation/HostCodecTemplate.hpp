@@ -0,0 +1,176 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <variant>
+
+/*Host-side packet codec for {{board}}
+-AUTOGENERATED CODE, DO NOT MODIFY-
+Header-only, for host tools (not firmware). Layouts come from the same JSON_ADE
+schema as DataPackets.hpp/OrderPackets.hpp: little endian, uint16_t id first, no padding.
+Only fixed-size packets and orders are included.*/
+namespace packet_codec {
+
+inline constexpr const char *BOARD_NAME = "{{board}}";
+
+// Batched datagrams (Core/Inc/Communications/PacketBatch.hpp)
+inline constexpr uint16_t BATCH_ID = 0xFFFF;
+
+namespace detail {
+template <typename T> inline T load(const uint8_t *data, size_t offset) {
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+}
+template <typename T> inline void store(uint8_t *data, size_t offset, const T &value) {
+    std::memcpy(data + offset, &value, sizeof(T));
+}
+} // namespace detail
+
+{% for section in sections %}
+// ============================================
+// {{section.title}}
+// ============================================
+namespace {{section.namespace}} {
+{% for enum in section.enums %}
+enum class {{enum.name}} : uint8_t {
+{%- for value in enum["values"] %}
+    {{value}} = {{loop.index0}},
+{%- endfor %}
+};
+{% endfor %}
+{%- for packet in section.packets %}
+struct {{packet.name}} {
+    static constexpr uint16_t ID = {{packet.id}};
+    static constexpr size_t WIRE_SIZE = {{packet.wire_size}};
+{% for variable in packet.variables %}
+    {{variable.type}} {{variable.name}}{};
+{%- endfor %}
+
+    static {{packet.name}} decode(const uint8_t *bytes) {
+        {{packet.name}} packet;
+        {%- for variable in packet.variables %}
+        packet.{{variable.name}} = detail::load<{{variable.type}}>(bytes, {{variable.offset}});
+        {%- endfor %}
+        {%- if not packet.variables %}
+        (void)bytes;
+        {%- endif %}
+        return packet;
+    }
+
+    void encode(uint8_t *out) const {
+        detail::store<uint16_t>(out, 0, ID);
+        {%- for variable in packet.variables %}
+        detail::store(out, {{variable.offset}}, {{variable.name}});
+        {%- endfor %}
+    }
+
+    std::array<uint8_t, WIRE_SIZE> encode() const {
+        std::array<uint8_t, WIRE_SIZE> out{};
+        encode(out.data());
+        return out;
+    }
+};
+{% endfor %}
+using Any = std::variant<std::monostate{% for packet in section.packets %}, {{packet.name}}{% endfor %}>;
+
+// Wire size of a packet id, 0 when the id is unknown
+constexpr size_t wire_size(uint16_t id) {
+    switch (id) {
+    {%- for packet in section.packets %}
+    case {{packet.name}}::ID:
+        return {{packet.name}}::WIRE_SIZE;
+    {%- endfor %}
+    default:
+        return 0;
+    }
+}
+
+// Decode one complete packet. Unknown id or wrong length yields std::nullopt.
+inline std::optional<Any> decode(std::span<const uint8_t> frame) {
+    if (frame.size() < sizeof(uint16_t)) {
+        return std::nullopt;
+    }
+    uint16_t id = detail::load<uint16_t>(frame.data(), 0);
+    if (wire_size(id) == 0 || frame.size() != wire_size(id)) {
+        return std::nullopt;
+    }
+    switch (id) {
+    {%- for packet in section.packets %}
+    case {{packet.name}}::ID:
+        return Any{ {{packet.name}}::decode(frame.data()) };
+    {%- endfor %}
+    default:
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief Decode back-to-back packets (a TCP capture or a raw dump). Bytes with an unknown id
+ * are skipped one at a time to resynchronize. Returns the bytes consumed; a trailing partial
+ * packet is left for the next call.
+ */
+template <typename Visitor> size_t decode_stream(std::span<const uint8_t> bytes, Visitor &&visit) {
+    size_t offset = 0;
+    while (bytes.size() - offset >= sizeof(uint16_t)) {
+        size_t size = wire_size(detail::load<uint16_t>(bytes.data(), offset));
+        if (size == 0) {
+            offset++;
+            continue;
+        }
+        if (bytes.size() - offset < size) {
+            break;
+        }
+        if (auto packet = decode(bytes.subspan(offset, size))) {
+            visit(*packet);
+        }
+        offset += size;
+    }
+    return offset;
+}
+
+/**
+ * @brief Decode one UDP datagram, either a single packet or a PacketBatch.
+ * Returns false if the datagram is malformed.
+ */
+template <typename Visitor> bool decode_datagram(std::span<const uint8_t> datagram, Visitor &&visit) {
+    if (datagram.size() < sizeof(uint16_t)) {
+        return false;
+    }
+    if (detail::load<uint16_t>(datagram.data(), 0) != BATCH_ID) {
+        auto packet = decode(datagram);
+        if (packet) {
+            visit(*packet);
+        }
+        return packet.has_value();
+    }
+    if (datagram.size() < sizeof(uint16_t) + sizeof(uint8_t)) {
+        return false;
+    }
+    size_t count = datagram[sizeof(uint16_t)];
+    size_t offset = sizeof(uint16_t) + sizeof(uint8_t);
+    for (size_t i = 0; i < count; i++) {
+        if (datagram.size() - offset < sizeof(uint16_t)) {
+            return false;
+        }
+        size_t length = detail::load<uint16_t>(datagram.data(), offset);
+        offset += sizeof(uint16_t);
+        if (datagram.size() - offset < length) {
+            return false;
+        }
+        auto packet = decode(datagram.subspan(offset, length));
+        if (!packet) {
+            return false;
+        }
+        visit(*packet);
+        offset += length;
+    }
+    return offset == datagram.size();
+}
+
+} // namespace {{section.namespace}}
+{% endfor %}
+} // namespace packet_codec
@@ -1,5 +1,6 @@
 #pragma once
 #include "ST-LIB.hpp"
+#include "Communications/StaticSlot.hpp"
 
 /*Order packets for {{board}}
 -AUTOGENERATED CODE, DO NOT MODIFY- */
@@ -23,13 +24,17 @@ public:
     OrderPackets() = default;
 
     {% for packet in packets -%}
-    inline static HeapOrder *{{packet.name}}_order{nullptr};
+    using {{packet.name}}_order_t = {% if packet.fixed_size %}StackOrder<sizeof(uint16_t){% for variable in packet.variables %} + sizeof({{variable.type}}){% endfor %}{% for variable in packet.variables %}, {{variable.type}}{% endfor %}>{% else %}HeapOrder{% endif %};
+    {% endfor %}
+
+    {% for packet in packets -%}
+    inline static {{packet.name}}_order_t *{{packet.name}}_order{nullptr};
     {% endfor %}
 
     {% for packet in packets -%}
     static void {{packet.name}}_init({% for variable in packet.variables %}{{variable.type}} &{{variable.name}}{% if not loop.last %}, {% endif %}{% endfor %})
     {
-        {{packet.name}}_order = new HeapOrder({{packet.id}}, &{{packet.name}}_cb{% if packet.variables %}, {% for variable in packet.variables %}&{{variable.name}}{% if not loop.last %}, {% endif %}{% endfor %}{% endif %});
+        {{packet.name}}_order = {{packet.name}}_slot.emplace(static_cast<uint16_t>({{packet.id}}), &{{packet.name}}_cb{% if packet.variables %}, {% for variable in packet.variables %}&{{variable.name}}{% if not loop.last %}, {% endif %}{% endfor %}{% endif %});
     }
     {% endfor %}
 
@@ -40,6 +45,17 @@ public:
     inline static {{socket.type}} *{{socket.name}}{nullptr};
     {% endfor %}
 
+    // Static storage: no heap allocation, sizes visible in the map file
+    {% for packet in packets -%}
+    constinit inline static StaticSlot<{{packet.name}}_order_t> {{packet.name}}_slot{};
+    {% endfor %}
+    {% for socket in Sockets -%}
+    constinit inline static StaticSlot<{{socket.type}}> {{socket.name}}_slot{};
+    {% endfor %}
+    {% for socket in ServerSockets -%}
+    constinit inline static StaticSlot<{{socket.type}}> {{socket.name}}_slot{};
+    {% endfor %}
+
     static void start()
     {
         {% for packet in packets -%}
@@ -49,10 +65,10 @@ public:
         {% endfor %}
 
         {% for socket in ServerSockets -%}
-        {{socket.name}} = new ServerSocket("{{socket.board_ip}}",{{socket.port}});
+        {{socket.name}} = {{socket.name}}_slot.emplace("{{socket.board_ip}}",{{socket.port}});
         {%- endfor %}
         {% for socket in Sockets -%}
-        {{socket.name}} = new Socket("{{socket.board_ip}}",{{socket.local_port}},"{{socket.remote_ip}}",{{socket.remote_port}});
+        {{socket.name}} = {{socket.name}}_slot.emplace("{{socket.board_ip}}",{{socket.local_port}},"{{socket.remote_ip}}",{{socket.remote_port}});
         {% endfor %}
     }
 
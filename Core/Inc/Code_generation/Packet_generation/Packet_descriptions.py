@@ -110,13 +110,26 @@ class BoardDescription:
                     remote_ip = sock["remote_ip"]
                     if remote_ip == "backend":
                         remote_ip = self.backend_ip
-                    self.DatagramSockets.append({"name": name, "type": sock_type, "board_ip": self.board_ip, "port": sock["port"], "remote_ip": remote_ip})
+                    self.DatagramSockets.append({"name": name, "type": sock_type, "board_ip": self.board_ip, "port": sock["port"], "remote_ip": remote_ip, "batch": bool(sock.get("batch", False))})
 
 
 
+# Ids the firmware sends or receives outside JSON_ADE, on the same sockets
+RESERVED_PACKET_IDS = {
+    0xFFFF: "PacketBatchFormat::BATCH_ID (Communications/PacketBatch.hpp)",
+    0xFFFE: "ControlTrace::TRACE_ID (Telemetry/ControlTrace.hpp)",
+    0xFFFD: "REPORT_ID (Examples/ExampleBenchmark.cpp)",
+    0xFFFC: "ReplayCapture::CAPTURE_ID (Telemetry/ReplayCapture.hpp)",
+    0xFFFB: "ControlParameters::SET_ID (Control/ControlParameters.hpp)",
+    0xFFFA: "ControlParameters::STATUS_ID (Control/ControlParameters.hpp)",
+}
+
 class PacketDescription:
     def __init__(self, packet:dict,measurements:list, filename:str="Unknown"):
         self.id =packet["id"]
+        packet_id = int(self.id, 0) if isinstance(self.id, str) else int(self.id)
+        if packet_id in RESERVED_PACKET_IDS:
+            raise Exception(f"Packet {packet['name']} in file {filename} uses id {packet_id:#06x}, reserved for {RESERVED_PACKET_IDS[packet_id]}")
         self.name = packet["name"].replace(" ", "_").replace("-", "_")
         self.type = packet["type"]
         self.variables = []
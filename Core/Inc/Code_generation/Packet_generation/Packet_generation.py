@@ -1,10 +1,85 @@
 from Packet_generation.Packet_descriptions import *
+import hashlib
 import json
 import os
 import jinja2
 import sys
 
 templates_path = "Core/Inc/Code_generation/Packet_generation"
+packets_path = "Core/Inc/Communications/Packets"
+host_codec_path = "out/codec"
+
+# Types with a compile-time wire size (StackPacket/StackOrder): type -> (struct format, size).
+# Packets with any other field type (containers) fall back to HeapPacket/HeapOrder.
+# Host tools take their layouts from here too (see json_type_layout).
+FIXED_SIZE_TYPES = {
+    "bool": ("?", 1),
+    "uint8_t": ("B", 1), "uint16_t": ("H", 2), "uint32_t": ("I", 4), "uint64_t": ("Q", 8),
+    "int8_t": ("b", 1), "int16_t": ("h", 2), "int32_t": ("i", 4), "int64_t": ("q", 8),
+    "float": ("f", 4), "double": ("d", 8),
+}
+ENUM_LAYOUT = ("B", 1)
+
+def is_fixed_size_packet(packet_instance: PacketDescription):
+    for measurement in packet_instance.measurements:
+        if not hasattr(measurement, "enum") and measurement.type not in FIXED_SIZE_TYPES:
+            return False
+    return True
+
+def packet_wire_size(packet_instance: PacketDescription):
+    # Bytes on the wire of a fixed-size packet: the uint16_t id, then every field
+    size = 2
+    for measurement in packet_instance.measurements:
+        _, field_size = ENUM_LAYOUT if hasattr(measurement, "enum") else FIXED_SIZE_TYPES[measurement.type]
+        size += field_size
+    return size
+
+def json_type_layout(json_type: str):
+    # Wire layout of a JSON_ADE measurement type ("uint8", "float32", "enum", ...)
+    if json_type == "enum":
+        return ENUM_LAYOUT
+    return FIXED_SIZE_TYPES[MeasurmentsDescription._numeric_type_correction(json_type)]
+
+def wire_type(measurement, scope: str):
+    # Enum fields are qualified so a field may share its enum's name in the wire struct
+    if hasattr(measurement, "enum"):
+        return f"{scope}::{measurement.type}"
+    return measurement.type
+
+#--------------Incremental output---------------#
+
+def content_hash(content: str):
+    return hashlib.sha256(content.encode()).hexdigest()
+
+def file_hash(path: str):
+    if not os.path.exists(path):
+        return None
+    with open(path, "rb") as f:
+        return hashlib.sha256(f.read()).hexdigest()
+
+def write_if_changed(path: str, content: str):
+    # Identical content keeps the old mtime, so nothing including the file rebuilds
+    if file_hash(path) == content_hash(content):
+        return False
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as f:
+        f.write(content)
+    return True
+
+def remove_if_exists(path: str):
+    if os.path.exists(path):
+        os.remove(path)
+
+def board_header_path(board: str, header: str):
+    return f"{packets_path}/{board}/{header}"
+
+def Generate_forwarding_hpp(board: str, header: str):
+    # Packets/<header> selects the per-board header of the BOARD_NAME being built
+    path = f"{packets_path}/{header}"
+    if not os.path.exists(board_header_path(board, header)):
+        remove_if_exists(path)
+        return
+    write_if_changed(path, f"#pragma once\n/*-AUTOGENERATED CODE, DO NOT MODIFY-*/\n#include \"{board}/{header}\"\n")
 
 def Generate_PacketDescription(JSONpath:str,board:str):
     with open(JSONpath+"/boards.json") as f:
@@ -58,10 +133,14 @@ def Get_data_context(board:BoardDescription):
                     for measurement in packet_instance.measurements:
                         packet_variables.append({
                             "name": measurement.id.replace(" ", "_").replace("-", "_"),
-                            "type": measurement.type
+                            "type": measurement.type,
+                            "wire_type": wire_type(measurement, "DataPackets")
                         })
 
-                    aux_packet = {"name": packet_instance.name, "data": tempdata_but_pointer.replace(" ", "_").replace("-", "_"), "id": packet_instance.id, "variables": packet_variables}
+                    fixed_size = is_fixed_size_packet(packet_instance)
+                    aux_packet = {"name": packet_instance.name, "data": tempdata_but_pointer.replace(" ", "_").replace("-", "_"), "id": packet_instance.id, "variables": packet_variables, "fixed_size": fixed_size}
+                    if fixed_size:
+                        aux_packet["wire_size"] = packet_wire_size(packet_instance)
                     Packets.append(aux_packet)
                     for measurement in packet_instance.measurements:
                         aux_data = {"type": measurement.type, "name": measurement.id.replace(" ", "_").replace("-", "_")}
@@ -95,15 +174,40 @@ def Get_data_context(board:BoardDescription):
             else:
                 grouped_lookup[key].append({"socket": socket_name, "name": names})
 
+        # Sockets with "batch": true send the fixed-size packets of a group as one datagram
+        batch_sockets = {s["name"] for s in board.sockets.DatagramSockets if s.get("batch", False)}
+        fixed_size_packets = {p["name"] for p in packets if p["fixed_size"]}
+
         grouped_list = []
         for (period, period_type), items in grouped_lookup.items():
+            singles = []
+            batched = {}
+            for item in items:
+                if item["socket"] in batch_sockets and item["name"] in fixed_size_packets:
+                    batched.setdefault(item["socket"], []).append(item["name"])
+                else:
+                    singles.append(item)
+
+            batches = []
+            for socket_name, names in batched.items():
+                if len(names) == 1:
+                    singles.append({"socket": socket_name, "name": names[0]})
+                    continue
+                batches.append({
+                    "name": f"batch_{period}{period_type}_{socket_name}".replace(".", "_"),
+                    "socket": socket_name,
+                    "packets": names
+                })
+
             grouped_list.append({
                 "period": period,
                 "period_type": period_type,
-                "packets": items
+                "packets": singles,
+                "batches": batches
             })
         return grouped_list
 
+    sending_packets = GenerateGroupedSendingPackets(board)
     context = {
         "board": board.name,
         "enums": GenerateDataEnum(board),
@@ -113,12 +217,13 @@ def Get_data_context(board:BoardDescription):
         "Sockets":board.sockets.Sockets,
         "DatagramSockets":board.sockets.DatagramSockets,
         "DatagramSocketNames": [s["name"] for s in board.sockets.DatagramSockets],
-        "sending_packets": GenerateGroupedSendingPackets(board),
+        "sending_packets": sending_packets,
+        "batches": [batch for group in sending_packets for batch in group["batches"]],
     }
     return context
 
 def Generate_DataPackets_hpp(board_input:str):
-    data_packets_path = "Core/Inc/Communications/Packets/DataPackets.hpp"
+    data_packets_path = board_header_path(board_input, "DataPackets.hpp")
     board_instance = globals()[board_input]
     if board_instance.data_size == 0 and len(board_instance.sockets.DatagramSockets) == 0:
         if os.path.exists(data_packets_path):
@@ -130,8 +235,7 @@ def Generate_DataPackets_hpp(board_input:str):
     context = Get_data_context(board_instance)
 
 
-    with open(data_packets_path,"w") as Output:
-        Output.write(template.render(context))
+    write_if_changed(data_packets_path, template.render(context))
 
 #--------------OrderPackets.hpp generation---------------#
 
@@ -168,7 +272,7 @@ def Get_order_context(board: BoardDescription):
                             "type": measurement.type
                         })
 
-                    aux_packet = {"name": packet_instance.name, "data": tempdata_but_pointer, "id": packet_instance.id, "variables": packet_variables}
+                    aux_packet = {"name": packet_instance.name, "data": tempdata_but_pointer, "id": packet_instance.id, "variables": packet_variables, "fixed_size": is_fixed_size_packet(packet_instance)}
                     Packets.append(aux_packet)
                     for measurement in packet_instance.measurements:
                         aux_data = {"type": measurement.type, "name": measurement.name}
@@ -190,7 +294,7 @@ def Get_order_context(board: BoardDescription):
     return context
 
 def Generate_OrderPackets_hpp(board_input:str):
-    order_packets_path = "Core/Inc/Communications/Packets/OrderPackets.hpp"
+    order_packets_path = board_header_path(board_input, "OrderPackets.hpp")
     board_instance = globals()[board_input]
     if (board_instance.order_size == 0 and len(board_instance.sockets.ServerSockets) == 0 and len(board_instance.sockets.Sockets) == 0):
         if os.path.exists(order_packets_path):
@@ -201,5 +305,40 @@ def Generate_OrderPackets_hpp(board_input:str):
     template = env.get_template("OrderTemplate.hpp")
     context = Get_order_context(board_instance)
 
-    with open(order_packets_path, "w") as Output:
-        Output.write(template.render(context))
+    write_if_changed(order_packets_path, template.render(context))
+
+#--------------Host codec generation---------------#
+
+def host_codec_file(board: str):
+    return f"{host_codec_path}/{board}/PacketCodec.hpp"
+
+def Get_host_codec_section(context: dict, title: str, namespace: str):
+    enum_names = {enum["name"] for enum in context["enums"]}
+    packets = []
+    for packet in context["packets"]:
+        if not packet["fixed_size"]:
+            continue
+        offset = 2
+        variables = []
+        for variable in packet["variables"]:
+            is_enum = variable["type"] in enum_names
+            _, size = ENUM_LAYOUT if is_enum else FIXED_SIZE_TYPES[variable["type"]]
+            # Enum types are qualified so a field may share its enum's name
+            cpp_type = f"{namespace}::{variable['type']}" if is_enum else variable["type"]
+            variables.append({"name": variable["name"], "type": cpp_type, "offset": offset})
+            offset += size
+        packets.append({"name": packet["name"], "id": packet["id"], "variables": variables, "wire_size": offset})
+    return {"title": title, "namespace": namespace, "enums": context["enums"], "packets": packets}
+
+def Generate_HostCodec_hpp(board_input: str):
+    board_instance = globals()[board_input]
+    env = jinja2.Environment(loader=jinja2.FileSystemLoader(templates_path))
+    template = env.get_template("HostCodecTemplate.hpp")
+    context = {
+        "board": board_instance.name,
+        "sections": [
+            Get_host_codec_section(Get_data_context(board_instance), "Data packets (board -> host)", "data"),
+            Get_host_codec_section(Get_order_context(board_instance), "Orders (host -> board)", "orders"),
+        ],
+    }
+    write_if_changed(host_codec_file(board_input), template.render(context))
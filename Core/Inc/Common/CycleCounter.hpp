@@ -0,0 +1,24 @@
+#ifndef CYCLE_COUNTER_HPP
+#define CYCLE_COUNTER_HPP
+
+#include "main.h"
+
+// DWT cycle counter (core clock cycles, wraps every ~7.8 s at 550 MHz).
+// Differences between two reads are valid across a single wrap.
+namespace CycleCounter {
+
+inline void init() {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+inline uint32_t now() { return DWT->CYCCNT; }
+
+inline uint32_t elapsed(uint32_t since) { return DWT->CYCCNT - since; }
+
+inline uint32_t to_us(uint32_t cycles) { return cycles / (SystemCoreClock / 1'000'000U); }
+
+} // namespace CycleCounter
+
+#endif // CYCLE_COUNTER_HPP
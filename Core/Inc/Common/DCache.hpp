@@ -0,0 +1,49 @@
+#ifndef DCACHE_HPP
+#define DCACHE_HPP
+
+#include "main.h"
+#include "C++Utilities/CppImports.hpp"
+
+// ============================================
+// D-cache maintenance for DMA buffers
+// ============================================
+// For buffers that cannot live in the non-cacheable DMA region (e.g. buffers
+// owned by LCU-Shared). All operations are no-ops while the D-cache is off.
+//
+//   CPU -> DMA (tx): clean() before starting the transfer.
+//   DMA -> CPU (rx): invalidate() before starting the transfer (so no dirty line
+//                    gets evicted on top of it) and again once it completes. Only
+//                    for line-aligned, line-sized buffers: anything else receives
+//                    into a DMA_BUFFER and is copied out.
+namespace DCache {
+
+inline constexpr uintptr_t LINE_SIZE = 32;
+
+inline bool is_enabled() { return (SCB->CCR & SCB_CCR_DC_Msk) != 0U; }
+
+inline bool is_line_aligned(const volatile void* ptr, size_t size) {
+    auto addr = reinterpret_cast<uintptr_t>(ptr);
+    return (addr % LINE_SIZE) == 0 && (size % LINE_SIZE) == 0;
+}
+
+inline void clean(const volatile void* ptr, size_t size) {
+    if (!is_enabled() || size == 0) {
+        return;
+    }
+    SCB_CleanDCache_by_Addr(const_cast<volatile void*>(ptr), static_cast<int32_t>(size));
+}
+
+/**
+ * @brief Invalidate a DMA receive buffer. It must be line-aligned and line-sized
+ * (is_line_aligned()): a line shared with other data would lose the CPU's writes.
+ */
+inline void invalidate(volatile void* ptr, size_t size) {
+    if (!is_enabled() || size == 0) {
+        return;
+    }
+    SCB_InvalidateDCache_by_Addr(ptr, static_cast<int32_t>(size));
+}
+
+} // namespace DCache
+
+#endif // DCACHE_HPP
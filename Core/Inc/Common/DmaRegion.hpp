@@ -0,0 +1,61 @@
+#ifndef DMA_REGION_HPP
+#define DMA_REGION_HPP
+
+#include "main.h"
+#include "ST-LIB.hpp"
+
+// Symbols from Core/Linker/DMA_placement.ld
+extern "C" {
+extern uint32_t _sdma_buffers;
+extern uint32_t _edma_buffers;
+}
+
+// ============================================
+// Non-cacheable DMA buffer region
+// ============================================
+namespace DmaRegion {
+
+// Highest region number wins on overlap and stays clear of the ST-LIB regions
+inline constexpr uint8_t MPU_REGION = MPU_REGION_NUMBER15;
+inline constexpr uint8_t MPU_REGION_SIZE_ENCODING = MPU_REGION_SIZE_1KB;
+inline constexpr size_t REGION_SIZE = 1024;
+
+inline uintptr_t base() { return reinterpret_cast<uintptr_t>(&_sdma_buffers); }
+
+inline size_t size() { return reinterpret_cast<uintptr_t>(&_edma_buffers) - base(); }
+
+/**
+ * @brief Zero the (NOLOAD) region. Call before any peripheral can start a transfer.
+ */
+inline void clear() { std::memset(&_sdma_buffers, 0, size()); }
+
+/**
+ * @brief Map the region as normal, non-cacheable, shareable memory.
+ */
+inline void configure_mpu() {
+    if (size() != REGION_SIZE || (base() % REGION_SIZE) != 0) {
+        ErrorHandler("DMA region is not a single MPU-mappable block");
+        return;
+    }
+
+    MPU_Region_InitTypeDef region{};
+    region.Enable = MPU_REGION_ENABLE;
+    region.Number = MPU_REGION;
+    region.BaseAddress = static_cast<uint32_t>(base());
+    region.Size = MPU_REGION_SIZE_ENCODING;
+    region.SubRegionDisable = 0x00;
+    region.TypeExtField = MPU_TEX_LEVEL1;
+    region.AccessPermission = MPU_REGION_FULL_ACCESS;
+    region.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+    region.IsShareable = MPU_ACCESS_SHAREABLE;
+    region.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+    region.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+
+    HAL_MPU_Disable();
+    HAL_MPU_ConfigRegion(&region);
+    HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+}
+
+} // namespace DmaRegion
+
+#endif // DMA_REGION_HPP
@@ -0,0 +1,59 @@
+#ifndef EVENT_QUEUE_HPP
+#define EVENT_QUEUE_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "Common/CycleCounter.hpp"
+#include "Common/SpscRing.hpp"
+
+// ============================================
+// Event Queue (interrupt -> background loop)
+// ============================================
+// Timestamped events from one interrupt source, handled by the background loop
+// in the order they happened. Unlike a volatile flag, a burst of events between
+// two polls is not collapsed into one: every event is delivered with the DWT
+// time it was posted at.
+//
+// One queue per producing interrupt (SpscRing is single-producer). post() never
+// blocks; when the queue is full the event is dropped and counted.
+
+template <typename Event, size_t Capacity> class EventQueue {
+public:
+    struct Entry {
+        uint32_t cycles; // DWT timestamp of post()
+        Event event;
+    };
+
+    // Producer: interrupt context
+    bool post(Event event) { return ring.push(Entry{CycleCounter::now(), event}); }
+
+    /**
+     * @brief Consumer: hand up to max pending entries to handler(entry), oldest first.
+     * Returns the number handled.
+     */
+    template <typename Handler> size_t drain(Handler&& handler, size_t max = Capacity) {
+        size_t handled = 0;
+        Entry entry;
+        while (handled < max && ring.pop(entry)) {
+            uint32_t latency = CycleCounter::elapsed(entry.cycles);
+            if (latency > worst_latency) {
+                worst_latency = latency;
+            }
+            handler(entry);
+            handled++;
+        }
+        return handled;
+    }
+
+    bool empty() const { return ring.empty(); }
+
+    uint32_t dropped() const { return ring.dropped(); }
+
+    // Longest post() -> handler time seen, in cycles
+    uint32_t worst_latency_cycles() const { return worst_latency; }
+
+private:
+    SpscRing<Entry, Capacity> ring;
+    uint32_t worst_latency = 0;
+};
+
+#endif // EVENT_QUEUE_HPP
@@ -0,0 +1,33 @@
+#ifndef PLACEMENT_HPP
+#define PLACEMENT_HPP
+
+// ============================================
+// Tightly Coupled Memory placement
+// ============================================
+// ITCM/DTCM are zero-wait-state and bypass the cache, so code and data placed
+// there have the same latency on every control tick. The sections are laid out
+// by Core/Linker/TCM_placement.ld and loaded by tcm_init() before constructors.
+//
+// DTCM is NOT reachable by DMA1/DMA2/BDMA: never place DMA buffers here.
+//
+// With USE_TCM off (cmake -DUSE_TCM=OFF) the macros expand to nothing, which is
+// the baseline configuration for worst-case timing comparisons.
+
+#ifdef USE_TCM
+#define ITCM_CODE __attribute__((section(".itcm_text"), noinline))
+#define DTCM_DATA __attribute__((section(".dtcm_data")))
+#else
+#define ITCM_CODE
+#define DTCM_DATA
+#endif
+
+// ============================================
+// Non-cacheable DMA buffers
+// ============================================
+// Laid out by Core/Linker/DMA_placement.ld (RAM_D2) and mapped non-cacheable by
+// DmaRegion::configure_mpu(), so DMA stays coherent with the D-cache enabled.
+// The region is NOLOAD: initializers are ignored, DmaRegion::clear() zeroes it.
+
+#define DMA_BUFFER __attribute__((section(".dma_buffers"), aligned(32)))
+
+#endif // PLACEMENT_HPP
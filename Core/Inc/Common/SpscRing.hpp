@@ -0,0 +1,81 @@
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include <atomic>
+
+// ============================================
+// Single-producer / single-consumer ring
+// ============================================
+// Lock-free hand-off between one interrupt (producer) and the background loop
+// (consumer). push() never blocks and never waits for the consumer: when the ring
+// is full the new element is dropped and counted, so a late or missed drain only
+// loses data, it never delays the control loop.
+//
+// head is written only by the producer and tail only by the consumer; both are
+// free-running counters, so Capacity must be a power of two.
+
+template <typename T, size_t Capacity> class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "SpscRing elements are copied as raw data");
+
+public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Producer side
+    bool push(const T& value) {
+        uint32_t head = head_index.load(std::memory_order_relaxed);
+        if (head - tail_index.load(std::memory_order_acquire) >= Capacity) {
+            dropped_count.store(dropped_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[head & (Capacity - 1)] = value;
+        head_index.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& value) {
+        uint32_t tail = tail_index.load(std::memory_order_relaxed);
+        if (tail == head_index.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = slots[tail & (Capacity - 1)];
+        tail_index.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop up to max elements into out. Returns the number popped.
+     */
+    size_t pop_bulk(T* out, size_t max) {
+        uint32_t tail = tail_index.load(std::memory_order_relaxed);
+        size_t available = head_index.load(std::memory_order_acquire) - tail;
+        size_t count = std::min(available, max);
+        for (size_t i = 0; i < count; i++) {
+            out[i] = slots[(tail + i) & (Capacity - 1)];
+        }
+        tail_index.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consumer side: drop everything currently queued
+    void clear() { tail_index.store(head_index.load(std::memory_order_acquire), std::memory_order_release); }
+
+    size_t size() const {
+        return head_index.load(std::memory_order_acquire) - tail_index.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+
+    // Elements rejected because the ring was full, since boot
+    uint32_t dropped() const { return dropped_count.load(std::memory_order_relaxed); }
+
+private:
+    std::array<T, Capacity> slots{};
+    std::atomic<uint32_t> head_index{0};
+    std::atomic<uint32_t> tail_index{0};
+    std::atomic<uint32_t> dropped_count{0};
+};
+
+#endif // SPSC_RING_HPP
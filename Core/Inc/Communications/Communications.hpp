@@ -5,15 +5,18 @@
 #include "StateMachine/LCU_StateMachine.hpp"
 #include "ConfigShared.hpp"
 #include "CommunicationsShared.hpp"
+#include "Common/Placement.hpp"
+#include "Common/DCache.hpp"
+#include "Telemetry/ReplayCapture.hpp"
 
 namespace Communications {
 
 // Communications object to hold command/status packets
-inline CommunicationsBase comms;
+DTCM_DATA inline CommunicationsBase comms;
 
 // SPI
 inline LCU_Slave::SpiType* g_spi = nullptr;
-inline ST_LIB::DigitalOutputDomain::Instance* g_slave_ready = nullptr;
+inline LCU_Slave::DigitalOutputType* g_slave_ready = nullptr;
 
 // Inner State Machine flags
 volatile bool send_flag = false;
@@ -29,13 +32,35 @@ uint32_t spi_timeout_counter = 0;
 #endif // USE_SPI_TIMEOUT
 #endif // USE_SPI_ERROR
 
+// ============================================
+// Frame buffer cache maintenance
+// ============================================
+// Frame::tx_buffer/rx_buffer are owned by LCU-Shared and cannot be moved into the
+// non-cacheable DMA region. tx_buffer is cleaned before each transfer, which is
+// safe on lines it shares with other data. rx_buffer has no alignment guarantee,
+// and invalidating a line it shares would discard CPU writes next to it. The SPI
+// therefore receives into rx_dma_buffer (non-cacheable, DMA_BUFFER), which is
+// copied into rx_buffer once the transfer completes.
+
+using RxBuffer = std::remove_cvref_t<decltype(LCU_Slave::Frame::rx_buffer)>;
+
+DMA_BUFFER inline RxBuffer rx_dma_buffer;
+
+inline void prepare_transfer() {
+    DCache::clean(LCU_Slave::Frame::tx_buffer, sizeof(LCU_Slave::Frame::tx_buffer));
+}
+
+inline void complete_transfer() {
+    std::memcpy(LCU_Slave::Frame::rx_buffer, rx_dma_buffer, sizeof(RxBuffer));
+}
+
 // ============================================
 // Status Reporting
 // ============================================
 
 inline void update_status() {
     auto& status = comms.status_packet;
-    status.slave_state = LCU_SM::sm_operational.get_current_state();
+    status.slave_state = LCU_SM::slave_state();
 }
 
 // ============================================
@@ -93,12 +118,15 @@ inline void update() {
 
     } else if (send_flag) {
         send_flag = false;
-        g_spi->transceive(LCU_Slave::Frame::tx_buffer, LCU_Slave::Frame::rx_buffer, &spi_flag);
+        prepare_transfer();
+        g_spi->transceive(LCU_Slave::Frame::tx_buffer, rx_dma_buffer, &spi_flag);
         g_spi->set_software_nss(true);
         g_slave_ready->turn_on();
 
     } else if (spi_flag) {
         spi_flag = false;
+        complete_transfer();
+        ReplayCapture::record_frame();
         g_slave_ready->turn_off();
         g_spi->set_software_nss(false);
 
@@ -0,0 +1,68 @@
+#ifndef PACKET_BATCH_HPP
+#define PACKET_BATCH_HPP
+
+#include "ST-LIB.hpp"
+
+// ============================================
+// Batched datagram
+// ============================================
+// Coalesces every packet of one sending group into a single datagram, so a group
+// costs one lwIP/Ethernet send instead of one per packet. Enabled per socket with
+// "batch": true in the JSON_ADE sockets.json; the generator only batches packets
+// with a fixed wire size (generated *_packet_t classes with WIRE_SIZE).
+//
+// Wire format (little endian):
+//   uint16_t BATCH_ID | uint8_t count | count x { uint16_t length | packet bytes }
+// where the packet bytes are exactly what the packet sends on its own (id first).
+// Host-side decoder: tools/packet_batch_decode.py
+
+namespace PacketBatchFormat {
+inline constexpr uint16_t BATCH_ID = 0xFFFF; // Reserved, never a JSON_ADE packet id
+inline constexpr size_t HEADER_SIZE = sizeof(uint16_t) + sizeof(uint8_t);
+inline constexpr size_t SUB_HEADER_SIZE = sizeof(uint16_t);
+} // namespace PacketBatchFormat
+
+template <typename... Packets>
+class PacketBatch final
+    : public StackPacket<
+          PacketBatchFormat::HEADER_SIZE +
+          ((PacketBatchFormat::SUB_HEADER_SIZE + Packets::WIRE_SIZE) + ... + 0)> {
+public:
+    static constexpr size_t SIZE = PacketBatchFormat::HEADER_SIZE +
+                                   ((PacketBatchFormat::SUB_HEADER_SIZE + Packets::WIRE_SIZE) +
+                                    ... + 0);
+
+    static_assert(sizeof...(Packets) > 0 && sizeof...(Packets) <= UINT8_MAX,
+                  "A batch holds between 1 and 255 packets");
+    static_assert(((Packets::WIRE_SIZE <= UINT16_MAX) && ...), "Packet too large for a batch");
+
+    explicit PacketBatch(Packets*... packets)
+        : StackPacket<SIZE>(PacketBatchFormat::BATCH_ID), packets(packets...) {}
+
+    uint8_t* build() override {
+        size_t offset = 0;
+        put<uint16_t>(offset, PacketBatchFormat::BATCH_ID);
+        put<uint8_t>(offset, sizeof...(Packets));
+        std::apply([&](auto*... packet) { (append(offset, *packet), ...); }, packets);
+        return wire();
+    }
+
+private:
+    std::tuple<Packets*...> packets;
+
+    // The StackPacket's own buffer: the one its size and id describe
+    uint8_t* wire() { return std::data(this->buffer); }
+
+    template <typename T> void put(size_t& offset, T value) {
+        std::memcpy(wire() + offset, &value, sizeof(T));
+        offset += sizeof(T);
+    }
+
+    template <typename P> void append(size_t& offset, P& packet) {
+        put<uint16_t>(offset, static_cast<uint16_t>(P::WIRE_SIZE));
+        std::memcpy(wire() + offset, packet.P::build(), P::WIRE_SIZE);
+        offset += P::WIRE_SIZE;
+    }
+};
+
+#endif // PACKET_BATCH_HPP
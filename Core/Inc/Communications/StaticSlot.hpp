@@ -0,0 +1,44 @@
+#ifndef STATIC_SLOT_HPP
+#define STATIC_SLOT_HPP
+
+#include "C++Utilities/CppImports.hpp"
+
+// ============================================
+// Static storage for runtime-constructed objects
+// ============================================
+// Holds exactly one T in static storage. The slot itself is constant-initialized
+// (usable as constinit), so its size shows up at link time, and emplace() builds
+// the object in place when its runtime arguments (variable references, IPs) are
+// known. Used by the generated DataPackets/OrderPackets instead of `new`.
+template <typename T> class StaticSlot {
+public:
+    constexpr StaticSlot() = default;
+    StaticSlot(const StaticSlot&) = delete;
+    StaticSlot& operator=(const StaticSlot&) = delete;
+
+    /**
+     * @brief Construct the object in place, destroying the previous one if any.
+     */
+    template <typename... Args> T* emplace(Args&&... args) {
+        reset();
+        object = ::new (static_cast<void*>(storage)) T(std::forward<Args>(args)...);
+        return object;
+    }
+
+    void reset() {
+        if (object != nullptr) {
+            object->~T();
+            object = nullptr;
+        }
+    }
+
+    T* get() const { return object; }
+
+    static constexpr size_t size() { return sizeof(T); }
+
+private:
+    alignas(T) std::byte storage[sizeof(T)]{};
+    T* object = nullptr;
+};
+
+#endif // STATIC_SLOT_HPP
@@ -3,38 +3,248 @@
 
 #include "C++Utilities/CppImports.hpp"
 #include "LCU_SLAVE_Types.hpp"
+#include "Common/Placement.hpp"
+#include "Control/ControlExecutive.hpp"
+#include "Control/GainSchedule.hpp"
+#include "Control/LevitationGainSchedule.hpp"
+#include "Control/MimoLevitation.hpp"
+#include "Control/Pid.hpp"
 
 extern "C" {
 #include "control.h"
 }
 
 namespace Control {
-void init() { control_initialize(); }
 
-float current_update() {
-#ifdef USE_1_DOF
-    control_U.corriente_real = LCU_Slave::g_lpu_array->get_lpu<0>().shunt_v;
+// The generated controller only covers a single LPU/airgap pair so far
+inline constexpr bool HAS_CONTROLLER = Topology::DOF == 1;
 
-    control_step0();
+inline constexpr size_t LPU_COUNT = LCU_Slave::LpuArrayType::size();
 
-    return control_Y.Voltage;
+// ============================================
+// Native current loop (USE_NATIVE_CURRENT_CONTROL)
+// ============================================
+// One PI per shunt channel in place of the generated control_step0(), with the
+// same discrete semantics (Pid.hpp): the step inlines into the current task
+// instead of going through the control_U/control_Y structs. host/conformance
+// checks it against the generated step on recorded currents.
+//
+// LPUs that share a shunt channel (Topology: LPUs 6-10 read the channels of
+// LPUs 1-5) have no current feedback of their own. The channel's PI closes the
+// loop on its first LPU, with that LPU's reference, and every LPU on the channel
+// gets its voltage. The other LPUs' references are not used.
+//
+// 5-DOF builds always run it: there is no generated current loop there, and the
+// MIMO outer loop hands its references to this one.
 
-#elif defined(USE_5_DOF)
-    // (TODO)
-    return 0.0f;
+#ifdef USE_NATIVE_CURRENT_CONTROL
+inline constexpr bool NATIVE_CURRENT = true;
+#else
+inline constexpr bool NATIVE_CURRENT = Topology::DOF == 5;
 #endif
-}
 
-void levitation_update(float reference) {
-#ifdef USE_1_DOF
-    control_U.Gap = LCU_Slave::g_airgap_array->get_airgap<0>().airgap_v;
-    control_U.Referencia = reference;
+inline constexpr PidConfig CURRENT_PI_CONFIG{
+    .sample_time_s =
+        ControlExecutive::period_us(ControlExecutive::RateGroup::CURRENT) * 1e-6f,
+    .anti_windup = AntiWindup::CLAMPING,
+    .derivative = false,
+};
+
+using CurrentPi = Pid<CURRENT_PI_CONFIG>;
+
+// Starting values for builds without a generated current loop (5-DOF). 1-DOF builds
+// start from the model's own gains instead (load_gains()). Tunable at runtime as
+// ControlParameters::Block::CURRENT_PI.
+inline constexpr PidGains CURRENT_PI_GAINS{
+    .kp = 10.0f,
+    .ki = 1000.0f,
+    .kd = 0.0f,
+    .filter = 0.0f,
+    .back_calculation = 0.0f,
+    .output_min = -48.0f,
+    .output_max = 48.0f,
+};
+
+inline constexpr size_t SHUNT_CHANNELS = Topology::SHUNT_ADCS.size();
+
+// First LPU on each shunt channel: the one its PI closes the loop on
+inline constexpr auto SHUNT_OWNER = [] {
+    std::array<size_t, SHUNT_CHANNELS> owner{};
+    owner.fill(LPU_COUNT);
+    for (size_t i = LPU_COUNT; i-- > 0;) {
+        owner[Topology::LPUS[i].shunt] = i;
+    }
+    return owner;
+}();
+
+static_assert(
+    std::ranges::none_of(SHUNT_OWNER, [](size_t lpu) { return lpu == LPU_COUNT; }),
+    "Every shunt channel needs an LPU"
+);
+
+DTCM_DATA inline PidGains current_gains = CURRENT_PI_GAINS;
+DTCM_DATA inline std::array<CurrentPi, SHUNT_CHANNELS> current_pi{};
 
-    control_step1();
+// Current reference of each LPU, in A. Written by the outer loop; the generated
+// outer loop keeps its output inside the model, so it stays at zero with it. Only
+// the first LPU of each shunt channel is regulated to its reference.
+DTCM_DATA inline std::array<float, LPU_COUNT> current_reference{};
 
-#elif defined(USE_5_DOF)
-    // (TODO)
+// Output of the last current step for each LPU, in V
+DTCM_DATA inline std::array<float, LPU_COUNT> target_voltage{};
+
+// ============================================
+// 5-DOF levitation loop
+// ============================================
+// No generated outer loop covers 5 DOF: MimoLevitation turns the airgaps into the
+// current references of the native current loop.
+
+// Tunable at runtime as ControlParameters::Block::LEVITATION_AXES
+DTCM_DATA inline std::array<PidGains, MimoLevitation::AXIS_COUNT> levitation_gains =
+    MimoLevitation::AXIS_GAINS;
+
+// Whether the slave may enter LEVITATING. The 1-DOF outer loop is the generated
+// model, which only levitates through its own current loop: control_step1() keeps
+// its current reference inside the model and never writes current_reference, so
+// with the native current loop the magnet would hold zero current. In 5-DOF the
+// axis controllers need wiring that observes every axis, the vehicle's geometry
+// and tuned gains.
+inline constexpr bool CAN_LEVITATE =
+    Topology::DOF == 1
+        ? !NATIVE_CURRENT
+        : (MimoLevitation::VEHICLE_OBSERVABLE && MimoLevitation::GEOMETRY_MEASURED &&
+           MimoLevitation::AXIS_GAINS_TUNED);
+
+// Heave gains scheduled over the airgap (Control/LevitationGainSchedule.hpp).
+// Held until a 5-DOF build can levitate: a schedule for a loop that never runs
+// cannot be checked, and the 1-DOF outer loop's gains are inside the model.
+#ifdef USE_LEVITATION_GAIN_SCHEDULE
+inline constexpr bool GAIN_SCHEDULE = true;
+#else
+inline constexpr bool GAIN_SCHEDULE = false;
 #endif
+
+static_assert(
+    !GAIN_SCHEDULE || (Topology::DOF == 5 && CAN_LEVITATE),
+    "USE_LEVITATION_GAIN_SCHEDULE is held until a 5-DOF build can levitate "
+    "(Control::CAN_LEVITATE)"
+);
+
+// Only stepped in 5-DOF builds
+DTCM_DATA constinit inline MimoLevitation::Controller<MimoLevitation::AIRGAP_CHANNELS, LPU_COUNT>
+    levitation{MimoLevitation::VEHICLE_GEOMETRY};
+
+/**
+ * @brief The current PI of the generated model as PidGains. The names of its
+ * parameters in control_P are not known to this tree, so they are identified from
+ * control_step0(): from a clean model, an error far past either limit returns that
+ * limit, a small error returns kp * e, and a zero error on the next step returns
+ * what it integrated, Ts * ki * e (the discretization of Pid.hpp). Leaves the model
+ * reset.
+ */
+inline PidGains model_current_gains() {
+    constexpr float LARGE_ERROR = 1e6f; // A
+    constexpr float SMALL_ERROR = 1e-3f;
+    // The model runs on a zero reference: the error is minus the measured current
+    auto respond = [](float error) {
+        control_U.corriente_real = -error;
+        control_step0();
+        return control_Y.Voltage;
+    };
+
+    PidGains gains = CURRENT_PI_GAINS;
+    control_initialize();
+    gains.output_max = respond(LARGE_ERROR);
+    control_initialize();
+    gains.output_min = respond(-LARGE_ERROR);
+    control_initialize();
+    gains.kp = respond(SMALL_ERROR) / SMALL_ERROR;
+    gains.ki = respond(0.0f) / (CurrentPi::SAMPLE_TIME_S * SMALL_ERROR);
+
+    control_U.corriente_real = 0.0f;
+    control_initialize();
+    return gains;
+}
+
+// Once at start-up, before init(): later init() calls keep the gains written at
+// runtime
+void load_gains() {
+    if constexpr (HAS_CONTROLLER) {
+        current_gains = model_current_gains();
+    }
+}
+
+void init() {
+    control_initialize();
+    for (auto& pi : current_pi) {
+        pi.reset();
+    }
+    current_reference.fill(0.0f);
+    target_voltage.fill(0.0f);
+    levitation.reset();
+}
+
+// Call with the LEVITATION group stopped. The current loop goes back to a zero
+// reference, which is what the generated model uses in CURRENT_CONTROL, instead of
+// holding the last outer loop output.
+void stop_levitation() { current_reference.fill(0.0f); }
+
+// Call before the LEVITATION group starts: the axis controllers start clean rather
+// than from the integrators of an earlier levitation
+void start_levitation() { levitation.reset(); }
+
+ITCM_CODE void current_update() {
+    if constexpr (NATIVE_CURRENT) {
+        // The owner of a channel comes before the other LPUs on it
+        std::array<float, SHUNT_CHANNELS> channel_voltage{};
+        LCU_Slave::g_lpu_array->for_each_indexed([&](auto& lpu, size_t i) {
+            size_t channel = Topology::LPUS[i].shunt;
+            if (SHUNT_OWNER[channel] == i) {
+                channel_voltage[channel] =
+                    current_pi[channel].step(current_gains, current_reference[i], lpu.shunt_v);
+            }
+            target_voltage[i] = channel_voltage[channel];
+        });
+        return;
+    }
+    static_assert(NATIVE_CURRENT || HAS_CONTROLLER, "No current loop in this build");
+    control_U.corriente_real = LCU_Slave::g_lpu_array->get_lpu<0>().shunt_v;
+
+    control_step0();
+
+    // The generated loop has a single output, applied to every LPU
+    target_voltage.fill(control_Y.Voltage);
+}
+
+ITCM_CODE void levitation_update(float reference) {
+    if constexpr (Topology::DOF == 5) {
+        // Airgaps that share a channel read the same sensor: one value per channel
+        std::array<float, MimoLevitation::AIRGAP_CHANNELS> channels{};
+        size_t i = 0;
+        LCU_Slave::g_airgap_array->for_each([&](auto& airgap) {
+            channels[Topology::AIRGAPS[i++].adc] = airgap.airgap_v;
+        });
+        const auto& coordinates = levitation.sense(channels);
+        if constexpr (GAIN_SCHEDULE) {
+            // Gains for the measured coordinate, in place before the step that uses them
+            constexpr size_t scheduled = static_cast<size_t>(LevitationGainSchedule::AXIS);
+            LevitationGainSchedule::Schedule::apply(
+                coordinates[scheduled],
+                levitation_gains[scheduled]
+            );
+        }
+        // The master commands the heave gap; the vehicle is held level and centered
+        levitation.actuate(
+            levitation_gains,
+            {reference, 0.0f, 0.0f, 0.0f, 0.0f},
+            current_reference
+        );
+    } else {
+        control_U.Gap = LCU_Slave::g_airgap_array->get_airgap<0>().airgap_v;
+        control_U.Referencia = reference;
+
+        control_step1();
+    }
 }
 
 void deinit() { control_terminate(); }
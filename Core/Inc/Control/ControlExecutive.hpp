@@ -0,0 +1,150 @@
+#ifndef CONTROL_EXECUTIVE_HPP
+#define CONTROL_EXECUTIVE_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "Common/CycleCounter.hpp"
+#include "Common/Placement.hpp"
+
+// ============================================
+// Control Executive
+// ============================================
+// Runs the control rate groups from a dedicated hardware timer interrupt instead
+// of the main loop Scheduler. Every rate group period is an integer multiple of
+// BASE_PERIOD_US, and groups fire in declaration order inside the same tick, so
+// the control groups always see the measurements taken in that tick.
+//
+// Communications, the state machine transitions and housekeeping stay in the
+// background loop; they only enable/disable groups.
+
+namespace ControlExecutive {
+
+inline constexpr uint32_t BASE_PERIOD_US = 100;
+
+enum class RateGroup : uint8_t {
+    SENSORS,    // ADC acquisition (LPU + Airgap)
+    CURRENT,    // Inner current loop
+    LEVITATION, // Outer airgap loop
+    COUNT
+};
+
+inline constexpr size_t RATE_GROUP_COUNT = static_cast<size_t>(RateGroup::COUNT);
+
+// Period of each rate group, in base ticks
+inline constexpr std::array<uint32_t, RATE_GROUP_COUNT> RATE_GROUP_DIVIDERS = {
+    1,  // SENSORS:    100 us
+    2,  // CURRENT:    200 us
+    10, // LEVITATION: 1000 us
+};
+
+static_assert(
+    std::ranges::all_of(RATE_GROUP_DIVIDERS, [](uint32_t divider) { return divider > 0; }),
+    "Rate group dividers must be non-zero"
+);
+
+inline constexpr uint32_t period_us(RateGroup group) {
+    return RATE_GROUP_DIVIDERS[static_cast<size_t>(group)] * BASE_PERIOD_US;
+}
+
+using Task = void (*)();
+
+DTCM_DATA inline std::array<Task, RATE_GROUP_COUNT> tasks{};
+
+// Runs at the start of every tick, before any group: the one point where what the
+// groups share (e.g. the controller parameters) may change between two steps
+DTCM_DATA inline Task boundary_task = nullptr;
+DTCM_DATA inline std::array<volatile bool, RATE_GROUP_COUNT> enabled{};
+DTCM_DATA inline std::array<volatile bool, RATE_GROUP_COUNT> start_pending{};
+DTCM_DATA inline std::array<uint32_t, RATE_GROUP_COUNT> phase{};
+
+// Cycles from enable() to the first run of the group, for the last enable
+inline std::array<uint32_t, RATE_GROUP_COUNT> enable_stamp{};
+inline std::array<volatile uint32_t, RATE_GROUP_COUNT> start_latency_cycles{};
+
+DTCM_DATA inline volatile uint32_t tick_count = 0;
+
+// Execution time of the tick interrupt body. The worst case is what the TCM
+// placement (USE_TCM) and the loop rates are judged by.
+DTCM_DATA inline volatile uint32_t last_tick_cycles = 0;
+DTCM_DATA inline volatile uint32_t worst_tick_cycles = 0;
+
+// Group tasks must be bound before the group is enabled
+inline void set_task(RateGroup group, Task task) { tasks[static_cast<size_t>(group)] = task; }
+
+inline void set_boundary_task(Task task) { boundary_task = task; }
+
+/**
+ * @brief Arm a group. It runs on the very next tick, after the groups declared before it,
+ * so the start latency is bounded by BASE_PERIOD_US regardless of the group divider.
+ */
+inline void enable(RateGroup group) {
+    auto i = static_cast<size_t>(group);
+    if (enabled[i] || start_pending[i]) {
+        return;
+    }
+    enable_stamp[i] = CycleCounter::now();
+    start_pending[i] = true;
+}
+
+inline void disable(RateGroup group) {
+    auto i = static_cast<size_t>(group);
+    start_pending[i] = false;
+    enabled[i] = false;
+}
+
+inline bool is_enabled(RateGroup group) {
+    auto i = static_cast<size_t>(group);
+    return enabled[i] || start_pending[i];
+}
+
+inline void reset_timing_stats() { worst_tick_cycles = 0; }
+
+inline uint32_t start_latency_us(RateGroup group) {
+    return CycleCounter::to_us(start_latency_cycles[static_cast<size_t>(group)]);
+}
+
+/**
+ * @brief Timer interrupt body. Runs every enabled group whose period is due on this tick.
+ */
+ITCM_CODE inline void tick() {
+    uint32_t start = CycleCounter::now();
+    uint32_t tick = tick_count + 1;
+    tick_count = tick;
+
+    if (boundary_task != nullptr) {
+        boundary_task();
+    }
+
+    for (size_t i = 0; i < RATE_GROUP_COUNT; i++) {
+        if (tasks[i] == nullptr) {
+            continue;
+        }
+        if (start_pending[i]) {
+            start_pending[i] = false;
+            phase[i] = tick;
+            enabled[i] = true;
+            start_latency_cycles[i] = CycleCounter::elapsed(enable_stamp[i]);
+        }
+        if (enabled[i] && ((tick - phase[i]) % RATE_GROUP_DIVIDERS[i]) == 0) {
+            tasks[i]();
+        }
+    }
+
+    uint32_t cycles = CycleCounter::elapsed(start);
+    last_tick_cycles = cycles;
+    if (cycles > worst_tick_cycles) {
+        worst_tick_cycles = cycles;
+    }
+}
+
+/**
+ * @brief Start the base tick on a timer reserved in the Board for this purpose only.
+ */
+template <typename TimerWrapper> inline void start(TimerWrapper& timer) {
+    CycleCounter::init();
+    timer.configure16bit([](void*) { tick(); }, nullptr, BASE_PERIOD_US);
+    timer.counter_enable();
+}
+
+} // namespace ControlExecutive
+
+#endif // CONTROL_EXECUTIVE_HPP
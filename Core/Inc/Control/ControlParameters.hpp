@@ -0,0 +1,323 @@
+#ifndef CONTROL_PARAMETERS_HPP
+#define CONTROL_PARAMETERS_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "Common/Placement.hpp"
+#include "Communications/StaticSlot.hpp"
+#include "Control/Control.hpp"
+#include <atomic>
+
+// ============================================
+// Control Parameters (runtime tuning)
+// ============================================
+// The controller gains live in the parameter struct of the generated model
+// (control_P) and, for the native loops, in Control::current_gains and
+// Control::levitation_gains. A ParameterSet is a versioned list of 32-bit word
+// writes into those blocks: the background loop validates a set and stages it,
+// and the control interrupt applies it at the start of a tick (ControlExecutive
+// boundary task), before any rate group runs. Every control step sees either the
+// old gains or the new ones, never a mix of both.
+//
+// Two sets are kept: the active one (last applied; its version goes out with
+// every ControlTrace sample and replay capture) and the staged one. stage()
+// refuses a new set while one is pending, so the interrupt never reads a set
+// that is being written.
+//
+// Only tunable model parameters take effect: values Simulink inlined into the
+// generated code are not in control_P.
+//
+// Transport: UDP on CONTROL_PARAMETERS_PORT (USE_ETHERNET). The SPI frame is laid
+// out by LCU-Shared and has no parameter block; a transport that gets one only
+// has to call stage().
+// Host tool: tools/control_parameters.py (resolves field names from control.h and Pid.hpp)
+
+#ifndef CONTROL_PARAMETERS_HOST_IP
+#define CONTROL_PARAMETERS_HOST_IP "192.168.1.9"
+#endif
+
+#ifndef CONTROL_PARAMETERS_PORT
+#define CONTROL_PARAMETERS_PORT 50403
+#endif
+
+namespace ControlParameters {
+
+// Parameter structs a set can write into
+enum class Block : uint8_t {
+    MODEL,           // control_P
+    CURRENT_PI,      // Control::current_gains (PidGains)
+    LEVITATION_AXES, // Control::levitation_gains (PidGains per MimoLevitation::Axis)
+    COUNT
+};
+
+inline constexpr size_t BLOCK_COUNT = static_cast<size_t>(Block::COUNT);
+
+struct Write {
+    uint8_t block;   // Block
+    uint8_t reserved;
+    uint16_t offset; // Bytes from the start of the block, 4-byte aligned
+    uint32_t value;  // Raw word (a real32_T, or half of a real_T)
+};
+
+static_assert(sizeof(Write) == 8, "Write is sent as raw bytes");
+
+// Enough for the gains of one loop; bigger retunes go as several versions
+inline constexpr size_t MAX_WRITES = 8;
+
+struct ParameterSet {
+    uint32_t version; // Chosen by the host; 0 is the compiled-in set
+    uint16_t count;
+    uint16_t reserved;
+    std::array<Write, MAX_WRITES> writes;
+};
+
+inline constexpr size_t SET_HEADER_SIZE = sizeof(ParameterSet) - sizeof(ParameterSet::writes);
+
+static_assert(
+    SET_HEADER_SIZE == 8 && sizeof(ParameterSet) == SET_HEADER_SIZE + MAX_WRITES * sizeof(Write),
+    "ParameterSet is sent as raw bytes and must not have padding"
+);
+
+// Bytes of a set that carry information (header and the used writes)
+inline constexpr size_t used_size(const ParameterSet& set) {
+    return SET_HEADER_SIZE + std::min<size_t>(set.count, MAX_WRITES) * sizeof(Write);
+}
+
+enum class Result : uint8_t {
+    STAGED,
+    BUSY,            // The previous set has not been applied yet
+    BAD_VERSION,     // Version 0 is reserved for the compiled-in parameters
+    TOO_MANY_WRITES,
+    BAD_BLOCK,
+    BAD_OFFSET,      // Misaligned or past the end of the block
+    SCHEDULED,       // Written by the gain schedule every LEVITATION tick
+};
+
+inline std::byte* block_base(uint8_t block) {
+    switch (static_cast<Block>(block)) {
+    case Block::MODEL:
+        return reinterpret_cast<std::byte*>(&control_P);
+    case Block::CURRENT_PI:
+        return reinterpret_cast<std::byte*>(&Control::current_gains);
+    case Block::LEVITATION_AXES:
+        return reinterpret_cast<std::byte*>(Control::levitation_gains.data());
+    default:
+        return nullptr;
+    }
+}
+
+inline constexpr size_t block_size(uint8_t block) {
+    switch (static_cast<Block>(block)) {
+    case Block::MODEL:
+        return sizeof(control_P);
+    case Block::CURRENT_PI:
+        return sizeof(Control::current_gains);
+    case Block::LEVITATION_AXES:
+        return sizeof(Control::levitation_gains);
+    default:
+        return 0;
+    }
+}
+
+// A write into a gain the levitation gain schedule owns. The schedule would overwrite
+// it at the next LEVITATION tick, so such sets are refused instead.
+inline bool scheduled(const Write& write) {
+    if (!Control::GAIN_SCHEDULE || static_cast<Block>(write.block) != Block::LEVITATION_AXES) {
+        return false;
+    }
+    const std::byte* field = block_base(write.block) + write.offset;
+    auto& gains = Control::levitation_gains[static_cast<size_t>(LevitationGainSchedule::AXIS)];
+    for (auto target : LevitationGainSchedule::TARGETS) {
+        if (field == reinterpret_cast<const std::byte*>(&(gains.*target))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+DTCM_DATA inline std::array<ParameterSet, 2> sets{};
+DTCM_DATA inline volatile uint8_t active_index = 0;
+inline std::atomic<bool> pending{false};
+
+inline uint32_t applied_count = 0;
+inline uint32_t rejected_count = 0;
+
+inline const ParameterSet& active() { return sets[active_index]; }
+
+ITCM_CODE inline uint32_t active_version() { return sets[active_index].version; }
+
+inline Result validate(const ParameterSet& set) {
+    if (set.version == 0) {
+        return Result::BAD_VERSION;
+    }
+    if (set.count > MAX_WRITES) {
+        return Result::TOO_MANY_WRITES;
+    }
+    for (size_t i = 0; i < set.count; i++) {
+        const auto& write = set.writes[i];
+        if (write.block >= BLOCK_COUNT) {
+            return Result::BAD_BLOCK;
+        }
+        if (write.offset % sizeof(uint32_t) != 0 ||
+            write.offset + sizeof(uint32_t) > block_size(write.block)) {
+            return Result::BAD_OFFSET;
+        }
+        if (scheduled(write)) {
+            return Result::SCHEDULED;
+        }
+    }
+    return Result::STAGED;
+}
+
+/**
+ * @brief Background: validate set and queue it for the next tick boundary.
+ */
+inline Result stage(const ParameterSet& set) {
+    if (pending.load(std::memory_order_acquire)) {
+        return Result::BUSY;
+    }
+    Result result = validate(set);
+    if (result != Result::STAGED) {
+        rejected_count++;
+        return result;
+    }
+    sets[1 - active_index] = set;
+    pending.store(true, std::memory_order_release);
+    return Result::STAGED;
+}
+
+/**
+ * @brief Control interrupt, at a tick boundary: apply the staged set, if any.
+ * Returns true when a set was applied.
+ */
+ITCM_CODE inline bool swap_pending() {
+    if (!pending.load(std::memory_order_acquire)) {
+        return false;
+    }
+    uint8_t next = 1 - active_index;
+    const auto& set = sets[next];
+    for (size_t i = 0; i < set.count; i++) {
+        const auto& write = set.writes[i];
+        std::memcpy(block_base(write.block) + write.offset, &write.value, sizeof(write.value));
+    }
+    active_index = next;
+    applied_count++;
+    pending.store(false, std::memory_order_release);
+    return true;
+}
+
+#ifdef STLIB_ETH
+
+// Reserved ids, next to the replay capture (0xFFFC)
+inline constexpr uint16_t SET_ID = 0xFFFB;    // Host -> board
+inline constexpr uint16_t STATUS_ID = 0xFFFA; // Board -> host
+
+inline constexpr size_t WRITES_SIZE = MAX_WRITES * sizeof(Write);
+
+// SET_ID fields. A set with version 0 and no writes only asks for a status.
+inline uint32_t received_sequence = 0; // Incremented by the host for every datagram
+inline uint32_t received_version = 0;
+inline uint32_t received_count = 0;
+inline std::array<uint8_t, WRITES_SIZE> received_writes{};
+
+// STATUS_ID fields
+inline uint32_t status_sequence = 0; // received_sequence this status answers
+inline uint32_t status_result = 0;   // Result of that set
+inline uint32_t status_active_version = 0;
+inline uint32_t status_applied = 0;
+inline uint32_t status_rejected = 0;
+
+using SetPacket = StackPacket<
+    sizeof(uint16_t) + 3 * sizeof(uint32_t) + WRITES_SIZE,
+    uint32_t,
+    uint32_t,
+    uint32_t,
+    std::array<uint8_t, WRITES_SIZE>>;
+using StatusPacket = StackPacket<
+    sizeof(uint16_t) + 5 * sizeof(uint32_t),
+    uint32_t,
+    uint32_t,
+    uint32_t,
+    uint32_t,
+    uint32_t>;
+
+inline constexpr uint32_t SERVICE_PERIOD_US = 10'000;
+
+constinit inline StaticSlot<DatagramSocket> socket_slot{};
+constinit inline StaticSlot<SetPacket> set_packet_slot{};
+constinit inline StaticSlot<StatusPacket> status_packet_slot{};
+inline DatagramSocket* parameters_socket = nullptr;
+inline StatusPacket* status_packet = nullptr;
+
+inline uint32_t handled_sequence = 0;
+inline uint32_t reported_version = 0;
+
+inline ParameterSet decode_received() {
+    ParameterSet set{};
+    set.version = received_version;
+    set.count = static_cast<uint16_t>(std::min<uint32_t>(received_count, UINT16_MAX));
+    std::memcpy(
+        set.writes.data(),
+        received_writes.data(),
+        std::min<size_t>(set.count, MAX_WRITES) * sizeof(Write)
+    );
+    return set;
+}
+
+// Answers every new datagram, and reports when a staged set went live
+inline void service() {
+    bool report = false;
+    if (received_sequence != handled_sequence) {
+        handled_sequence = received_sequence;
+        ParameterSet set = decode_received();
+        bool query = set.version == 0 && set.count == 0;
+        status_result = static_cast<uint32_t>(query ? Result::STAGED : stage(set));
+        status_sequence = handled_sequence;
+        report = true;
+    }
+    if (active_version() != reported_version) {
+        reported_version = active_version();
+        report = true;
+    }
+    if (!report) {
+        return;
+    }
+    status_active_version = reported_version;
+    status_applied = applied_count;
+    status_rejected = rejected_count;
+    parameters_socket->send_packet(*status_packet);
+}
+
+inline void start() {
+    parameters_socket = socket_slot.emplace(
+        LCU_BOARD_IP,
+        CONTROL_PARAMETERS_PORT,
+        CONTROL_PARAMETERS_HOST_IP,
+        CONTROL_PARAMETERS_PORT
+    );
+    set_packet_slot.emplace(
+        SET_ID,
+        &received_sequence,
+        &received_version,
+        &received_count,
+        &received_writes
+    );
+    status_packet = status_packet_slot.emplace(
+        STATUS_ID,
+        &status_sequence,
+        &status_result,
+        &status_active_version,
+        &status_applied,
+        &status_rejected
+    );
+    Scheduler::register_task(SERVICE_PERIOD_US, +[]() { service(); });
+}
+
+#else
+
+inline void start() {}
+
+#endif // STLIB_ETH
+
+} // namespace ControlParameters
+
+#endif // CONTROL_PARAMETERS_HPP
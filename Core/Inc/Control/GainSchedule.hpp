@@ -0,0 +1,79 @@
+#ifndef GAIN_SCHEDULE_HPP
+#define GAIN_SCHEDULE_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "Common/Placement.hpp"
+
+// ============================================
+// Gain Scheduling
+// ============================================
+// Controller gains as a function of one measured variable (the airgap for the
+// levitation loop), tabulated on a uniform grid and interpolated linearly. The
+// grid is uniform so a lookup is one multiply, one truncation and a lerp per gain:
+// no search, and the same cost at every operating point. Outside the grid the
+// end rows hold.
+//
+// Tables are constexpr data: written by tools/create_look_up_table.cpp
+// (gain-schedule mode) from the design laws, or built in place with
+// make_gain_table() when the law is constexpr.
+
+template <size_t Points, size_t Columns> struct GainTable {
+    static_assert(Points >= 2, "A gain table needs at least two points");
+
+    static constexpr size_t POINTS = Points;
+    static constexpr size_t COLUMNS = Columns;
+
+    float x_min;
+    float x_max;
+    std::array<std::array<float, Columns>, Points> rows;
+
+    /**
+     * @brief Gains at x, interpolated between the two nearest rows. NaN maps to x_min.
+     */
+    constexpr std::array<float, Columns> at(float x) const {
+        float position = (x - x_min) * (static_cast<float>(Points - 1) / (x_max - x_min));
+        if (!(position > 0.0f)) {
+            return rows.front();
+        }
+        if (position >= static_cast<float>(Points - 1)) {
+            return rows.back();
+        }
+        size_t i = static_cast<size_t>(position);
+        float fraction = position - static_cast<float>(i);
+
+        std::array<float, Columns> gains{};
+        for (size_t c = 0; c < Columns; c++) {
+            gains[c] = rows[i][c] + fraction * (rows[i + 1][c] - rows[i][c]);
+        }
+        return gains;
+    }
+};
+
+/**
+ * @brief Tabulate law(x) -> std::array<float, Columns> on Points evenly spaced x.
+ */
+template <size_t Points, size_t Columns, typename Law>
+constexpr GainTable<Points, Columns> make_gain_table(float x_min, float x_max, Law&& law) {
+    GainTable<Points, Columns> table{x_min, x_max, {}};
+    for (size_t i = 0; i < Points; i++) {
+        float x = x_min + (x_max - x_min) * static_cast<float>(i) / static_cast<float>(Points - 1);
+        table.rows[i] = law(x);
+    }
+    return table;
+}
+
+// Writes the gains of Table at x into a parameter struct before a controller step.
+// Targets holds one member pointer (float Params::*) per table column.
+template <const auto& Table, const auto& Targets> struct GainSchedule {
+    static_assert(Targets.size() == Table.COLUMNS, "One target per table column");
+    static_assert(Table.x_max > Table.x_min, "Gain table range is empty");
+
+    template <typename Params> ITCM_CODE static void apply(float x, Params& params) {
+        auto gains = Table.at(x);
+        for (size_t c = 0; c < Table.COLUMNS; c++) {
+            params.*Targets[c] = gains[c];
+        }
+    }
+};
+
+#endif // GAIN_SCHEDULE_HPP
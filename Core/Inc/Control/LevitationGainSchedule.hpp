@@ -0,0 +1,67 @@
+#ifndef LEVITATION_GAIN_SCHEDULE_HPP
+#define LEVITATION_GAIN_SCHEDULE_HPP
+
+// Generated by tools/create_look_up_table.cpp (gain-schedule): do not edit
+
+#include "Control/GainSchedule.hpp"
+#include "Control/MimoLevitation.hpp"
+#include "Control/Pid.hpp"
+
+namespace LevitationGainSchedule {
+
+// Levitation axis whose gains (Control::levitation_gains) are scheduled
+inline constexpr MimoLevitation::Axis AXIS = MimoLevitation::Axis::HEAVE;
+
+// Airgap 0.01 to 0.03 m, designed at 0.02 m. Columns:
+// kp ki kd
+inline constexpr GainTable<33, 3> TABLE{
+    0.00999999978f,
+    0.0299999993f,
+    {{
+        {750.0f, 7500.0f, 20.0f}, // 0.01 m
+        {796.875f, 7968.75f, 21.25f}, // 0.010625 m
+        {843.75f, 8437.5f, 22.5f}, // 0.01125 m
+        {890.625f, 8906.25f, 23.75f}, // 0.011875 m
+        {937.5f, 9375.0f, 25.0f}, // 0.0125 m
+        {984.375f, 9843.75f, 26.25f}, // 0.013125 m
+        {1031.25f, 10312.5f, 27.5f}, // 0.01375 m
+        {1078.125f, 10781.25f, 28.75f}, // 0.014375 m
+        {1125.0f, 11250.0f, 30.0f}, // 0.015 m
+        {1171.875f, 11718.75f, 31.25f}, // 0.015625 m
+        {1218.75f, 12187.5f, 32.5f}, // 0.01625 m
+        {1265.62488f, 12656.249f, 33.7499962f}, // 0.016875 m
+        {1312.5f, 13125.0f, 35.0f}, // 0.0175 m
+        {1359.375f, 13593.75f, 36.25f}, // 0.018125 m
+        {1406.25012f, 14062.501f, 37.5000038f}, // 0.01875 m
+        {1453.125f, 14531.25f, 38.75f}, // 0.019375 m
+        {1500.0f, 15000.0f, 40.0f}, // 0.02 m
+        {1546.875f, 15468.75f, 41.25f}, // 0.020625 m
+        {1593.75f, 15937.5f, 42.5f}, // 0.02125 m
+        {1640.625f, 16406.25f, 43.75f}, // 0.021875 m
+        {1687.5f, 16875.0f, 45.0f}, // 0.0225 m
+        {1734.375f, 17343.75f, 46.25f}, // 0.023125 m
+        {1781.25f, 17812.5f, 47.5f}, // 0.02375 m
+        {1828.125f, 18281.25f, 48.75f}, // 0.024375 m
+        {1875.0f, 18750.0f, 50.0f}, // 0.025 m
+        {1921.875f, 19218.75f, 51.25f}, // 0.025625 m
+        {1968.75f, 19687.5f, 52.5f}, // 0.02625 m
+        {2015.625f, 20156.25f, 53.75f}, // 0.026875 m
+        {2062.5f, 20625.0f, 55.0f}, // 0.0275 m
+        {2109.375f, 21093.75f, 56.25f}, // 0.028125 m
+        {2156.25f, 21562.5f, 57.5f}, // 0.02875 m
+        {2203.125f, 22031.25f, 58.75f}, // 0.029375 m
+        {2250.0f, 22500.0f, 60.0f}, // 0.03 m
+    }},
+};
+
+inline constexpr std::array<float PidGains::*, 3> TARGETS = {
+    &PidGains::kp,
+    &PidGains::ki,
+    &PidGains::kd,
+};
+
+using Schedule = GainSchedule<TABLE, TARGETS>;
+
+} // namespace LevitationGainSchedule
+
+#endif // LEVITATION_GAIN_SCHEDULE_HPP
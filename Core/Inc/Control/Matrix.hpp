@@ -0,0 +1,197 @@
+#ifndef CONTROL_MATRIX_HPP
+#define CONTROL_MATRIX_HPP
+
+#include "C++Utilities/CppImports.hpp"
+
+// ============================================
+// Fixed-size matrices for the control path
+// ============================================
+// Row-major float storage with the dimensions in the type, so a matrix-vector
+// product is straight-line code: every row is fully unrolled and accumulated in
+// two independent sums, which keeps both FPU pipelines of the M7 busy instead of
+// waiting on one chain of multiply-adds.
+//
+// The constexpr helpers below (products, inverse, pseudo-inverses) are meant for
+// compile time: they build the matrices the control step uses from geometry
+// tables, in double precision, and are not tuned for runtime use.
+
+template <size_t Rows, size_t Cols> struct Matrix {
+    static constexpr size_t ROWS = Rows;
+    static constexpr size_t COLS = Cols;
+
+    std::array<float, Rows * Cols> data{};
+
+    constexpr float& operator()(size_t row, size_t col) { return data[row * Cols + col]; }
+    constexpr float operator()(size_t row, size_t col) const { return data[row * Cols + col]; }
+};
+
+namespace MatrixMath {
+
+// Even and odd columns in separate sums
+template <size_t Row, size_t Rows, size_t Cols>
+inline constexpr float
+row_dot(const Matrix<Rows, Cols>& matrix, const std::array<float, Cols>& vector) {
+    float even = 0.0f;
+    float odd = 0.0f;
+    [&]<size_t... P>(std::index_sequence<P...>) {
+        ((even += matrix(Row, 2 * P) * vector[2 * P],
+          odd += matrix(Row, 2 * P + 1) * vector[2 * P + 1]),
+         ...);
+    }(std::make_index_sequence<Cols / 2>{});
+    if constexpr (Cols % 2 != 0) {
+        even += matrix(Row, Cols - 1) * vector[Cols - 1];
+    }
+    return even + odd;
+}
+
+template <size_t Rows, size_t Cols>
+inline constexpr std::array<float, Rows>
+multiply(const Matrix<Rows, Cols>& matrix, const std::array<float, Cols>& vector) {
+    std::array<float, Rows> result{};
+    [&]<size_t... R>(std::index_sequence<R...>) {
+        ((result[R] = row_dot<R>(matrix, vector)), ...);
+    }(std::make_index_sequence<Rows>{});
+    return result;
+}
+
+// Double precision working copy for the compile-time helpers
+template <size_t Rows, size_t Cols> using Exact = std::array<std::array<double, Cols>, Rows>;
+
+template <size_t Rows, size_t Cols>
+inline constexpr Exact<Cols, Rows> transpose(const Exact<Rows, Cols>& a) {
+    Exact<Cols, Rows> t{};
+    for (size_t r = 0; r < Rows; r++) {
+        for (size_t c = 0; c < Cols; c++) {
+            t[c][r] = a[r][c];
+        }
+    }
+    return t;
+}
+
+template <size_t Rows, size_t Inner, size_t Cols>
+inline constexpr Exact<Rows, Cols>
+product(const Exact<Rows, Inner>& a, const Exact<Inner, Cols>& b) {
+    Exact<Rows, Cols> p{};
+    for (size_t r = 0; r < Rows; r++) {
+        for (size_t c = 0; c < Cols; c++) {
+            for (size_t k = 0; k < Inner; k++) {
+                p[r][c] += a[r][k] * b[k][c];
+            }
+        }
+    }
+    return p;
+}
+
+// Not constexpr: reaching it during constant evaluation is the compile error
+inline void singular_matrix() {}
+
+/**
+ * @brief Gauss-Jordan inverse with partial pivoting. A singular matrix is a compile
+ * error when evaluated in a constant expression.
+ */
+template <size_t N> inline constexpr Exact<N, N> inverse(Exact<N, N> a) {
+    Exact<N, N> inv{};
+    for (size_t i = 0; i < N; i++) {
+        inv[i][i] = 1.0;
+    }
+    for (size_t col = 0; col < N; col++) {
+        size_t pivot = col;
+        for (size_t r = col + 1; r < N; r++) {
+            double candidate = a[r][col] < 0.0 ? -a[r][col] : a[r][col];
+            double best = a[pivot][col] < 0.0 ? -a[pivot][col] : a[pivot][col];
+            if (candidate > best) {
+                pivot = r;
+            }
+        }
+        if (a[pivot][col] == 0.0) {
+            singular_matrix();
+        }
+        std::swap(a[col], a[pivot]);
+        std::swap(inv[col], inv[pivot]);
+
+        double scale = 1.0 / a[col][col];
+        for (size_t c = 0; c < N; c++) {
+            a[col][c] *= scale;
+            inv[col][c] *= scale;
+        }
+        for (size_t r = 0; r < N; r++) {
+            if (r == col || a[r][col] == 0.0) {
+                continue;
+            }
+            double factor = a[r][col];
+            for (size_t c = 0; c < N; c++) {
+                a[r][c] -= factor * a[col][c];
+                inv[r][c] -= factor * inv[col][c];
+            }
+        }
+    }
+    return inv;
+}
+
+/**
+ * @brief Number of linearly independent rows (Gaussian elimination with partial
+ * pivoting; pivots below 1e-9 of the largest entry count as zero).
+ */
+template <size_t Rows, size_t Cols> inline constexpr size_t rank(Exact<Rows, Cols> a) {
+    double largest = 0.0;
+    for (const auto& row : a) {
+        for (double value : row) {
+            largest = std::max(largest, value < 0.0 ? -value : value);
+        }
+    }
+    double tolerance = 1e-9 * largest;
+
+    size_t independent = 0;
+    for (size_t col = 0; col < Cols && independent < Rows; col++) {
+        size_t pivot = independent;
+        for (size_t r = independent + 1; r < Rows; r++) {
+            double candidate = a[r][col] < 0.0 ? -a[r][col] : a[r][col];
+            double best = a[pivot][col] < 0.0 ? -a[pivot][col] : a[pivot][col];
+            if (candidate > best) {
+                pivot = r;
+            }
+        }
+        double best = a[pivot][col] < 0.0 ? -a[pivot][col] : a[pivot][col];
+        if (best <= tolerance) {
+            continue;
+        }
+        std::swap(a[independent], a[pivot]);
+        for (size_t r = independent + 1; r < Rows; r++) {
+            double factor = a[r][col] / a[independent][col];
+            for (size_t c = col; c < Cols; c++) {
+                a[r][c] -= factor * a[independent][c];
+            }
+        }
+        independent++;
+    }
+    return independent;
+}
+
+// Least-squares left inverse (A^T A)^-1 A^T of a tall, full column rank A
+template <size_t Rows, size_t Cols>
+inline constexpr Exact<Cols, Rows> left_pseudo_inverse(const Exact<Rows, Cols>& a) {
+    auto t = transpose(a);
+    return product(inverse(product(t, a)), t);
+}
+
+// Minimum-norm right inverse A^T (A A^T)^-1 of a wide, full row rank A
+template <size_t Rows, size_t Cols>
+inline constexpr Exact<Cols, Rows> right_pseudo_inverse(const Exact<Rows, Cols>& a) {
+    auto t = transpose(a);
+    return product(t, inverse(product(a, t)));
+}
+
+template <size_t Rows, size_t Cols>
+inline constexpr Matrix<Rows, Cols> to_matrix(const Exact<Rows, Cols>& a) {
+    Matrix<Rows, Cols> m{};
+    for (size_t r = 0; r < Rows; r++) {
+        for (size_t c = 0; c < Cols; c++) {
+            m(r, c) = static_cast<float>(a[r][c]);
+        }
+    }
+    return m;
+}
+
+} // namespace MatrixMath
+
+#endif // CONTROL_MATRIX_HPP
@@ -0,0 +1,261 @@
+#ifndef MIMO_LEVITATION_HPP
+#define MIMO_LEVITATION_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "Common/Placement.hpp"
+#include "Control/ControlExecutive.hpp"
+#include "Control/Matrix.hpp"
+#include "Control/Pid.hpp"
+#include "Topology/Topology.hpp"
+
+// ============================================
+// MIMO Levitation (5-DOF)
+// ============================================
+// Outer airgap loop of the 5-DOF vehicle, one step per LEVITATION tick:
+//
+//   airgaps --sensing--> axis coordinates --PID per axis--> axis commands
+//           --allocation--> current reference of every LPU
+//
+// The five axes are heave, pitch, roll, yaw and lateral. Sensing is the
+// least-squares inverse of the sensor kinematics and allocation the minimum-norm
+// inverse of the actuator kinematics, so each axis controller sees (and drives)
+// its own mode only. Both matrices are built at compile time from the geometry
+// tables: moving a sensor or a magnet is a table edit, not a retune of a matrix.
+//
+// Sensing works on airgap ADC channels, not on Topology::AIRGAPS entries: airgaps
+// that share a channel are one reading. The five axes need five independent
+// readings (observable()) and five independent magnet directions (controllable());
+// a geometry short of either gets all-zero matrices, and Control refuses to
+// levitate with it (Control::CAN_LEVITATE).
+//
+// Sign convention: each axis PID works on reference - coordinate, so a positive
+// command asks to raise its coordinate. Positive current pulls the magnet to its
+// rail, closing the gap it faces, so the allocation carries the minus sign: a
+// coordinate above its reference still asks for more current.
+
+namespace MimoLevitation {
+
+enum class Axis : uint8_t {
+    HEAVE,   // Mean vertical gap, m
+    PITCH,   // rad, nose up positive (closes the front gaps)
+    ROLL,    // rad, left side down positive (opens the left gaps)
+    YAW,     // rad, nose right positive (opens the front left lateral gap)
+    LATERAL, // Left lateral gap minus the mean, m
+    COUNT
+};
+
+inline constexpr size_t AXIS_COUNT = static_cast<size_t>(Axis::COUNT);
+
+using Topology::Direction;
+using Topology::Placement;
+
+// Airgaps: one placement per airgap channel
+template <size_t Airgaps, size_t Lpus> struct Geometry {
+    std::array<Placement, Airgaps> airgaps;
+    std::array<Placement, Lpus> lpus;
+};
+
+// How a unit of each axis changes the gap at this placement. Collocated, it is also
+// what a unit of current there does to each axis.
+inline constexpr std::array<double, AXIS_COUNT> kinematics(const Placement& placement) {
+    double x = placement.x_m;
+    double y = placement.y_m;
+    if (placement.direction == Direction::VERTICAL) {
+        return {1.0, -x, y, 0.0, 0.0};
+    }
+    double side = y >= 0.0 ? 1.0 : -1.0;
+    return {0.0, 0.0, 0.0, side * x, side};
+}
+
+template <size_t N>
+inline constexpr MatrixMath::Exact<N, AXIS_COUNT>
+kinematics(const std::array<Placement, N>& placements) {
+    MatrixMath::Exact<N, AXIS_COUNT> rows{};
+    for (size_t i = 0; i < N; i++) {
+        rows[i] = kinematics(placements[i]);
+    }
+    return rows;
+}
+
+// Every axis moves some reading, and no two axes move them the same way
+template <size_t Airgaps, size_t Lpus>
+inline constexpr bool observable(const Geometry<Airgaps, Lpus>& geometry) {
+    return MatrixMath::rank(kinematics(geometry.airgaps)) == AXIS_COUNT;
+}
+
+// The LPUs can push every axis on its own
+template <size_t Airgaps, size_t Lpus>
+inline constexpr bool controllable(const Geometry<Airgaps, Lpus>& geometry) {
+    return MatrixMath::rank(kinematics(geometry.lpus)) == AXIS_COUNT;
+}
+
+// Airgap channels -> axis coordinates
+template <size_t Airgaps, size_t Lpus>
+inline constexpr Matrix<AXIS_COUNT, Airgaps>
+sensing_matrix(const Geometry<Airgaps, Lpus>& geometry) {
+    if (!observable(geometry)) {
+        return {};
+    }
+    return MatrixMath::to_matrix(MatrixMath::left_pseudo_inverse(kinematics(geometry.airgaps)));
+}
+
+// Axis commands -> LPU currents. Negated: positive current lowers the coordinates.
+template <size_t Airgaps, size_t Lpus>
+inline constexpr Matrix<Lpus, AXIS_COUNT>
+allocation_matrix(const Geometry<Airgaps, Lpus>& geometry) {
+    if (!controllable(geometry)) {
+        return {};
+    }
+    auto actuation = MatrixMath::transpose(kinematics(geometry.lpus));
+    auto allocation = MatrixMath::right_pseudo_inverse(actuation);
+    for (auto& row : allocation) {
+        for (auto& value : row) {
+            value = -value;
+        }
+    }
+    return MatrixMath::to_matrix(allocation);
+}
+
+inline constexpr PidConfig AXIS_PID_CONFIG{
+    .sample_time_s =
+        ControlExecutive::period_us(ControlExecutive::RateGroup::LEVITATION) * 1e-6f,
+    .anti_windup = AntiWindup::CLAMPING,
+    .derivative = true,
+};
+
+using AxisPid = Pid<AXIS_PID_CONFIG>;
+
+// Commands in A (HEAVE, LATERAL) and A*m (the rotations), as the allocation takes them.
+// Starting values, not tuned on the vehicle: see AXIS_GAINS_TUNED.
+inline constexpr std::array<PidGains, AXIS_COUNT> AXIS_GAINS = {{
+    {.kp = 1500.0f, .ki = 15000.0f, .kd = 40.0f, .filter = 200.0f, .back_calculation = 0.0f,
+     .output_min = -60.0f, .output_max = 60.0f},
+    {.kp = 400.0f, .ki = 2000.0f, .kd = 12.0f, .filter = 200.0f, .back_calculation = 0.0f,
+     .output_min = -20.0f, .output_max = 20.0f},
+    {.kp = 150.0f, .ki = 750.0f, .kd = 4.0f, .filter = 200.0f, .back_calculation = 0.0f,
+     .output_min = -8.0f, .output_max = 8.0f},
+    {.kp = 400.0f, .ki = 2000.0f, .kd = 12.0f, .filter = 200.0f, .back_calculation = 0.0f,
+     .output_min = -20.0f, .output_max = 20.0f},
+    {.kp = 1000.0f, .ki = 5000.0f, .kd = 30.0f, .filter = 200.0f, .back_calculation = 0.0f,
+     .output_min = -30.0f, .output_max = 30.0f},
+}};
+
+// Set once AXIS_GAINS (and the placements in Topology) hold values checked on the
+// vehicle. Until both are set the slave refuses LEVITATING in 5-DOF
+// (Control::CAN_LEVITATE); CURRENT_CONTROL is unaffected.
+inline constexpr bool AXIS_GAINS_TUNED = false;
+inline constexpr bool GEOMETRY_MEASURED = false;
+
+template <size_t Airgaps, size_t Lpus> class Controller {
+public:
+    constexpr explicit Controller(const Geometry<Airgaps, Lpus>& geometry)
+        : sensing(sensing_matrix(geometry)), allocation(allocation_matrix(geometry)) {}
+
+    /**
+     * @brief One LEVITATION step: airgap channels in, the current reference of every
+     * LPU out.
+     */
+    ITCM_CODE void step(
+        const std::array<PidGains, AXIS_COUNT>& gains,
+        const std::array<float, AXIS_COUNT>& reference,
+        const std::array<float, Airgaps>& airgaps,
+        std::array<float, Lpus>& currents
+    ) {
+        sense(airgaps);
+        actuate(gains, reference, currents);
+    }
+
+    /**
+     * @brief First half of step(): the axis coordinates of airgaps. Gains that depend
+     * on them (a gain schedule) can be set before actuate().
+     */
+    ITCM_CODE const std::array<float, AXIS_COUNT>&
+    sense(const std::array<float, Airgaps>& airgaps) {
+        coordinates = MatrixMath::multiply(sensing, airgaps);
+        return coordinates;
+    }
+
+    /**
+     * @brief Second half of step(): the axis PIDs on the sensed coordinates, allocated.
+     */
+    ITCM_CODE void actuate(
+        const std::array<PidGains, AXIS_COUNT>& gains,
+        const std::array<float, AXIS_COUNT>& reference,
+        std::array<float, Lpus>& currents
+    ) {
+        for (size_t a = 0; a < AXIS_COUNT; a++) {
+            commands[a] = pid[a].step(gains[a], reference[a], coordinates[a]);
+        }
+        currents = MatrixMath::multiply(allocation, commands);
+    }
+
+    void reset() {
+        for (auto& axis : pid) {
+            axis.reset();
+        }
+        coordinates.fill(0.0f);
+        commands.fill(0.0f);
+    }
+
+    const std::array<float, AXIS_COUNT>& axis_coordinates() const { return coordinates; }
+    const std::array<float, AXIS_COUNT>& axis_commands() const { return commands; }
+
+private:
+    Matrix<AXIS_COUNT, Airgaps> sensing;
+    Matrix<Lpus, AXIS_COUNT> allocation;
+    std::array<AxisPid, AXIS_COUNT> pid{};
+    std::array<float, AXIS_COUNT> coordinates{};
+    std::array<float, AXIS_COUNT> commands{};
+};
+
+// The vehicle the controller is designed for: four vertical and four lateral gaps,
+// each on its own channel. host/mimo closes the loop on it.
+inline constexpr Geometry<8, 10> NOMINAL_GEOMETRY{
+    .airgaps = {{
+        {Direction::VERTICAL, 0.60f, 0.20f},
+        {Direction::VERTICAL, 0.60f, -0.20f},
+        {Direction::VERTICAL, -0.60f, 0.20f},
+        {Direction::VERTICAL, -0.60f, -0.20f},
+        {Direction::LATERAL, 0.60f, 0.25f},
+        {Direction::LATERAL, 0.60f, -0.25f},
+        {Direction::LATERAL, -0.60f, 0.25f},
+        {Direction::LATERAL, -0.60f, -0.25f},
+    }},
+    .lpus = {{
+        {Direction::VERTICAL, 0.60f, 0.20f},
+        {Direction::VERTICAL, 0.60f, -0.20f},
+        {Direction::VERTICAL, 0.0f, 0.20f},
+        {Direction::VERTICAL, 0.0f, -0.20f},
+        {Direction::VERTICAL, -0.60f, 0.20f},
+        {Direction::VERTICAL, -0.60f, -0.20f},
+        {Direction::LATERAL, 0.60f, 0.25f},
+        {Direction::LATERAL, 0.60f, -0.25f},
+        {Direction::LATERAL, -0.60f, 0.25f},
+        {Direction::LATERAL, -0.60f, -0.25f},
+    }},
+};
+
+static_assert(observable(NOMINAL_GEOMETRY) && controllable(NOMINAL_GEOMETRY));
+
+inline constexpr size_t AIRGAP_CHANNELS = Topology::AIRGAP_ADCS.size();
+
+// The board as wired (Topology): channel c sits where the airgaps read from it do
+inline constexpr auto VEHICLE_GEOMETRY = [] {
+    Geometry<AIRGAP_CHANNELS, Topology::LPU_COUNT> geometry{};
+    for (const auto& airgap : Topology::AIRGAPS) {
+        geometry.airgaps[airgap.adc] = airgap.placement;
+    }
+    for (size_t i = 0; i < Topology::LPU_COUNT; i++) {
+        geometry.lpus[i] = Topology::LPUS[i].placement;
+    }
+    return geometry;
+}();
+
+// False for the 5-DOF wiring in the tree: airgaps 6-8 repeat the vertical channels
+// 1-3, which leaves one lateral reading for yaw and lateral together
+inline constexpr bool VEHICLE_OBSERVABLE =
+    observable(VEHICLE_GEOMETRY) && controllable(VEHICLE_GEOMETRY);
+
+} // namespace MimoLevitation
+
+#endif // MIMO_LEVITATION_HPP
@@ -0,0 +1,107 @@
+#ifndef PID_HPP
+#define PID_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "Common/Placement.hpp"
+
+// ============================================
+// PID Controller
+// ============================================
+// Discrete parallel PID with the semantics of the Simulink Discrete PID
+// Controller block (Forward Euler integrator and derivative filter, output
+// saturation, clamping or back-calculation anti-windup), so a loop designed
+// and validated in the model behaves the same here:
+//
+//   e  = reference - measured
+//   u  = kp*e + integrator + ud + feed_forward,  ud = N*(kd*e - filter)
+//   y  = clamp(u, output_min, output_max)
+//   integrator += Ts*ki*e     (CLAMPING: skipped while it would push u further past a limit)
+//   integrator += Ts*(ki*e + kb*(y - u))   (BACK_CALCULATION)
+//   filter     += Ts*ud
+//
+// The configuration (rate, anti-windup, derivative path) is a template argument,
+// so the step inlines into straight-line code with no dead branches. Gains are
+// plain data passed to every step: one PidGains can drive several instances and
+// be retuned at runtime (ControlParameters).
+
+enum class AntiWindup : uint8_t {
+    NONE,
+    CLAMPING,
+    BACK_CALCULATION,
+};
+
+struct PidConfig {
+    float sample_time_s;
+    AntiWindup anti_windup = AntiWindup::CLAMPING;
+    bool derivative = false; // PI when false: the derivative path compiles out
+};
+
+// Sent as raw words by tools/control_parameters.py: floats only, keep the order
+struct PidGains {
+    float kp;
+    float ki;               // 1/s
+    float kd;               // s
+    float filter;           // Derivative filter coefficient N, 1/s
+    float back_calculation; // Anti-windup gain kb, 1/s
+    float output_min;
+    float output_max;
+};
+
+static_assert(sizeof(PidGains) == 7 * sizeof(float), "PidGains must not have padding");
+
+template <PidConfig Config> class Pid {
+    static_assert(Config.sample_time_s > 0.0f, "PID sample time must be positive");
+
+public:
+    static constexpr float SAMPLE_TIME_S = Config.sample_time_s;
+
+    /**
+     * @brief One controller step. Returns the saturated output. Not ITCM_CODE (which
+     * is noinline): it inlines into its caller, which is.
+     */
+    float step(
+        const PidGains& gains,
+        float reference,
+        float measured,
+        float feed_forward = 0.0f
+    ) {
+        float error = reference - measured;
+
+        float derivative = 0.0f;
+        if constexpr (Config.derivative) {
+            derivative = gains.filter * (gains.kd * error - filter);
+            filter += SAMPLE_TIME_S * derivative;
+        }
+
+        float unsaturated = gains.kp * error + integrator + derivative + feed_forward;
+        float output = std::clamp(unsaturated, gains.output_min, gains.output_max);
+
+        float integrator_input = gains.ki * error;
+        if constexpr (Config.anti_windup == AntiWindup::CLAMPING) {
+            // Same test as the block's clamping circuit: the dead zone output and the
+            // integrator input have the same sign
+            float excess = unsaturated - output;
+            if (excess != 0.0f && (excess > 0.0f) == (integrator_input > 0.0f)) {
+                integrator_input = 0.0f;
+            }
+        } else if constexpr (Config.anti_windup == AntiWindup::BACK_CALCULATION) {
+            integrator_input += gains.back_calculation * (output - unsaturated);
+        }
+        integrator += SAMPLE_TIME_S * integrator_input;
+
+        return output;
+    }
+
+    void reset(float initial_integrator = 0.0f) {
+        integrator = initial_integrator;
+        filter = 0.0f;
+    }
+
+    float integrator_state() const { return integrator; }
+
+private:
+    float integrator = 0.0f;
+    float filter = 0.0f;
+};
+
+#endif // PID_HPP
@@ -0,0 +1,167 @@
+#ifndef FILTER_BANK_HPP
+#define FILTER_BANK_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "Common/Placement.hpp"
+
+// ============================================
+// Filter Bank
+// ============================================
+// The same filter on Channels independent channels, updated together in one pass.
+// Type and order are template arguments, so an update is fixed-count loops with
+// no per-channel branching. The state of each tap is one contiguous array across
+// the channels. The inner loops therefore run over channels: every iteration is
+// an independent chain, and the compiler can interleave them to keep both FPU
+// pipelines of the M7 busy.
+//
+//   MOVING_AVERAGE  mean of the last window samples; the window is re-summed every
+//                   update (window * Channels adds), so it never drifts
+//   EXPONENTIAL     y += alpha * (x - y)
+//   BIQUAD          one second-order section, transposed direct form II
+//
+// The first update starts every channel in steady state at its first sample, so
+// there is no warm-up from zero. A non-finite sample is replaced by the channel's
+// last output, so one bad reading cannot poison the state.
+
+enum class FilterType : uint8_t {
+    MOVING_AVERAGE,
+    EXPONENTIAL,
+    BIQUAD,
+};
+
+struct FilterConfig {
+    FilterType type;
+    size_t window = 1;  // MOVING_AVERAGE, samples
+    float alpha = 1.0f; // EXPONENTIAL, in (0, 1]
+    // BIQUAD: y = b0 x + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+    float b0 = 1.0f;
+    float b1 = 0.0f;
+    float b2 = 0.0f;
+    float a1 = 0.0f;
+    float a2 = 0.0f;
+};
+
+inline constexpr FilterConfig moving_average(size_t window) {
+    return {.type = FilterType::MOVING_AVERAGE, .window = window};
+}
+
+inline constexpr FilterConfig exponential(float alpha) {
+    return {.type = FilterType::EXPONENTIAL, .alpha = alpha};
+}
+
+inline constexpr FilterConfig biquad(float b0, float b1, float b2, float a1, float a2) {
+    return {.type = FilterType::BIQUAD, .b0 = b0, .b1 = b1, .b2 = b2, .a1 = a1, .a2 = a2};
+}
+
+template <FilterConfig Config, size_t Channels> class FilterBank {
+    static_assert(Channels > 0, "A filter bank needs at least one channel");
+    static_assert(
+        Config.type != FilterType::MOVING_AVERAGE || Config.window >= 1,
+        "Moving average window must be at least one sample"
+    );
+    static_assert(
+        Config.type != FilterType::EXPONENTIAL || (Config.alpha > 0.0f && Config.alpha <= 1.0f),
+        "Exponential filter alpha must be in (0, 1]"
+    );
+    static_assert(
+        Config.type != FilterType::BIQUAD || 1.0f + Config.a1 + Config.a2 != 0.0f,
+        "Biquad has a pole at DC"
+    );
+
+    static constexpr bool IS_AVERAGE = Config.type == FilterType::MOVING_AVERAGE;
+    static constexpr bool IS_BIQUAD = Config.type == FilterType::BIQUAD;
+
+    // Only the state of the configured type takes memory
+    static constexpr size_t WINDOW = IS_AVERAGE ? Config.window : 0;
+    static constexpr size_t SECTION_STATES = IS_BIQUAD ? 2 : 0;
+
+    using Samples = std::array<float, Channels>;
+
+public:
+    static constexpr size_t CHANNELS = Channels;
+    static constexpr FilterConfig CONFIG = Config;
+
+    /**
+     * @brief Filter one sample of every channel, in place.
+     */
+    ITCM_CODE void update(Samples& values) {
+        if (!primed) {
+            reset(values);
+        }
+        for (size_t c = 0; c < Channels; c++) {
+            if (!std::isfinite(values[c])) {
+                values[c] = output[c];
+            }
+        }
+
+        if constexpr (IS_AVERAGE) {
+            history[head] = values;
+            head = head + 1 == WINDOW ? 0 : head + 1;
+
+            Samples sum = history[0];
+            for (size_t k = 1; k < WINDOW; k++) {
+                for (size_t c = 0; c < Channels; c++) {
+                    sum[c] += history[k][c];
+                }
+            }
+            constexpr float scale = 1.0f / static_cast<float>(WINDOW);
+            for (size_t c = 0; c < Channels; c++) {
+                output[c] = sum[c] * scale;
+            }
+        } else if constexpr (IS_BIQUAD) {
+            auto& s1 = state[0];
+            auto& s2 = state[1];
+            for (size_t c = 0; c < Channels; c++) {
+                float x = values[c];
+                float y = Config.b0 * x + s1[c];
+                s1[c] = Config.b1 * x - Config.a1 * y + s2[c];
+                s2[c] = Config.b2 * x - Config.a2 * y;
+                output[c] = y;
+            }
+        } else {
+            for (size_t c = 0; c < Channels; c++) {
+                output[c] += Config.alpha * (values[c] - output[c]);
+            }
+        }
+        values = output;
+    }
+
+    /**
+     * @brief Put every channel in steady state at values (non-finite values count as 0).
+     */
+    void reset(const Samples& values) {
+        Samples x{};
+        for (size_t c = 0; c < Channels; c++) {
+            x[c] = std::isfinite(values[c]) ? values[c] : 0.0f;
+        }
+
+        if constexpr (IS_AVERAGE) {
+            history.fill(x);
+            head = 0;
+            output = x;
+        } else if constexpr (IS_BIQUAD) {
+            constexpr float dc_gain =
+                (Config.b0 + Config.b1 + Config.b2) / (1.0f + Config.a1 + Config.a2);
+            for (size_t c = 0; c < Channels; c++) {
+                float y = dc_gain * x[c];
+                state[0][c] = y - Config.b0 * x[c];
+                state[1][c] = Config.b2 * x[c] - Config.a2 * y;
+                output[c] = y;
+            }
+        } else {
+            output = x;
+        }
+        primed = true;
+    }
+
+    const Samples& outputs() const { return output; }
+
+private:
+    std::array<Samples, WINDOW> history{};
+    std::array<Samples, SECTION_STATES> state{};
+    Samples output{};
+    size_t head = 0;
+    bool primed = false;
+};
+
+#endif // FILTER_BANK_HPP
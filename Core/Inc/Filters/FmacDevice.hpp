@@ -0,0 +1,165 @@
+#ifndef FMAC_DEVICE_HPP
+#define FMAC_DEVICE_HPP
+
+#include "ST-LIB.hpp"
+#include "Common/Placement.hpp"
+#include "Filters/FmacProgram.hpp"
+
+// Defined in Core/Src/Runes/Runes.cpp, set up by HAL_FMAC_MspInit (stm32h7xx_hal_msp.c)
+extern FMAC_HandleTypeDef hfmac;
+extern DMA_HandleTypeDef hdma_fmac_write;
+extern DMA_HandleTypeDef hdma_fmac_read;
+
+// ============================================
+// FMAC device (board)
+// ============================================
+// Runs a Fmac::Program on the FMAC with both buffers fed by DMA2: the write stream
+// copies a block of q1.15 samples into X1 and the read stream drains the same
+// number of outputs from Y, each paced by the FMAC's own DMA requests.
+//
+// The HAL only loads the program. Transfers are re-armed on the stream registers
+// and polled for completion, so a block costs a handful of register writes and no
+// interrupt: nothing depends on the HAL DMA callbacks or their IRQ handlers.
+// The host targets substitute HostBoard::MockFmac (host/HostBoard).
+//
+// This is the only owner of the FMAC and of DMA2 streams 0-2 (HAL_FMAC_MspInit):
+// with USE_FMAC_FILTERS, Runes.cpp drops the MultiplierAccelerator binding. The
+// Board's own DMA claim is the SPI (DMA1 streams 5 and 6). Streams the DMA domain
+// assigns on its own, such as the ADCs', are configured in Board::init(), before
+// start(). start() therefore refuses streams 0-2 if anything has configured them.
+
+class FmacDevice {
+public:
+    /**
+     * @brief Load program, clear the filter history and start the filter. After it,
+     * every sample written produces exactly one output.
+     */
+    bool start(const Fmac::Program& program) {
+        if (hfmac.State == HAL_FMAC_STATE_RESET) {
+            if (!streams_free()) {
+                return false;
+            }
+            hfmac.Instance = FMAC;
+            if (HAL_FMAC_Init(&hfmac) != HAL_OK) {
+                return false;
+            }
+        }
+
+        // The HAL takes the coefficients by non-const pointer
+        std::array<int16_t, Fmac::FIR_MAX_P> b = program.b;
+        std::array<int16_t, Fmac::IIR_MAX_P> a = program.a;
+        bool iir = program.function == Fmac::Function::IIR;
+
+        FMAC_FilterConfigTypeDef config{};
+        config.CoeffBaseAddress = program.x2_base();
+        config.CoeffBufferSize = program.x2_size();
+        config.InputBaseAddress = program.x1_base();
+        config.InputBufferSize = program.x1_size();
+        config.InputThreshold = FMAC_THRESHOLD_1;
+        config.OutputBaseAddress = program.y_base();
+        config.OutputBufferSize = program.y_size();
+        config.OutputThreshold = FMAC_THRESHOLD_1;
+        config.pCoeffB = b.data();
+        config.CoeffBSize = program.p;
+        config.pCoeffA = iir ? a.data() : nullptr;
+        config.CoeffASize = iir ? program.q : 0;
+        config.InputAccess = FMAC_BUFFER_ACCESS_NONE;
+        config.OutputAccess = FMAC_BUFFER_ACCESS_NONE;
+        config.Clip = FMAC_CLIP_ENABLED;
+        config.Filter = iir ? FMAC_FUNC_IIR_DIRECT_FORM_1 : FMAC_FUNC_CONVO_FIR;
+        config.P = program.p;
+        config.Q = program.q;
+        config.R = program.r;
+        if (HAL_FMAC_FilterConfig(&hfmac, &config) != HAL_OK) {
+            return false;
+        }
+
+        // Zero feedback history, then zero inputs until the first output shows up:
+        // from there on the stream is one output per input whatever X1 held
+        if (iir) {
+            std::array<int16_t, Fmac::IIR_MAX_P> zeros{};
+            if (HAL_FMAC_FilterPreload(&hfmac, nullptr, 0, zeros.data(), program.q) != HAL_OK) {
+                return false;
+            }
+        }
+        SET_BIT(FMAC->PARAM, FMAC_PARAM_START);
+        bool primed = false;
+        for (size_t i = 0; i <= program.p && !primed; i++) {
+            FMAC->WDATA = 0;
+            // An output takes about p + q FMAC clocks
+            for (size_t wait = 0; wait < 4U * (program.p + program.q) && !primed; wait++) {
+                primed = !READ_BIT(FMAC->SR, FMAC_SR_YEMPTY);
+            }
+        }
+        if (!primed) {
+            return false;
+        }
+        (void)FMAC->RDATA;
+
+        attach(hdma_fmac_write, &FMAC->WDATA);
+        attach(hdma_fmac_read, &FMAC->RDATA);
+        SET_BIT(FMAC->CR, FMAC_CR_DMAWEN | FMAC_CR_DMAREN);
+        return true;
+    }
+
+    /**
+     * @brief Queue count samples in and count outputs out. Both buffers must be
+     * DMA-reachable and stay untouched until busy() is false.
+     */
+    ITCM_CODE void transfer(const int16_t* input, int16_t* output, uint16_t count) {
+        // Outputs first: the read stream must be waiting before the samples arrive
+        rearm(hdma_fmac_read, output, count);
+        rearm(hdma_fmac_write, input, count);
+    }
+
+    ITCM_CODE bool busy() const { return enabled(hdma_fmac_write) || enabled(hdma_fmac_read); }
+
+private:
+    // Interrupt status and clear registers of a DMA controller, as the HAL lays them out
+    struct StreamFlags {
+        volatile uint32_t ISR;
+        volatile uint32_t reserved;
+        volatile uint32_t IFCR;
+    };
+
+    // DMA2 streams 0-2 and their DMAMUX1 channels (8-10) still in their reset state
+    static bool streams_free() {
+        for (auto* stream : {DMA2_Stream0, DMA2_Stream1, DMA2_Stream2}) {
+            if (stream->CR != 0) {
+                return false;
+            }
+        }
+        for (auto* channel : {DMAMUX1_Channel8, DMAMUX1_Channel9, DMAMUX1_Channel10}) {
+            if (READ_BIT(channel->CCR, DMAMUX_CxCR_DMAREQ_ID) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static DMA_Stream_TypeDef* stream_of(const DMA_HandleTypeDef& dma) {
+        return static_cast<DMA_Stream_TypeDef*>(dma.Instance);
+    }
+
+    static void attach(DMA_HandleTypeDef& dma, volatile uint32_t* fmac_register) {
+        auto* stream = stream_of(dma);
+        CLEAR_BIT(stream->CR, DMA_SxCR_EN);
+        stream->PAR = reinterpret_cast<uint32_t>(fmac_register);
+    }
+
+    ITCM_CODE static void rearm(DMA_HandleTypeDef& dma, const int16_t* memory, uint16_t count) {
+        auto* stream = stream_of(dma);
+        auto* flags = reinterpret_cast<StreamFlags*>(dma.StreamBaseAddress);
+        flags->IFCR = 0x3FU << (dma.StreamIndex & 0x1FU);
+        stream->M0AR = reinterpret_cast<uint32_t>(memory);
+        stream->NDTR = count;
+        SET_BIT(stream->CR, DMA_SxCR_EN);
+    }
+
+    // The stream clears EN itself once its last item is through
+    ITCM_CODE static bool enabled(const DMA_HandleTypeDef& dma) {
+        return READ_BIT(stream_of(dma)->CR, DMA_SxCR_EN) != 0;
+    }
+};
+
+#endif // FMAC_DEVICE_HPP
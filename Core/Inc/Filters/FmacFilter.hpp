@@ -0,0 +1,147 @@
+#ifndef FMAC_FILTER_HPP
+#define FMAC_FILTER_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "LCU_SLAVE_Types.hpp"
+#include "Common/Placement.hpp"
+#include "Filters/FmacProgram.hpp"
+#include "Filters/SensorChannels.hpp"
+
+// ============================================
+// FMAC Sensor Filters
+// ============================================
+// Filters the sensor channels (Filters/SensorChannels.hpp) on the FMAC, as one
+// interleaved stream (Filters/FmacProgram.hpp), one block per
+// SENSORS tick. In sensors_task, after the LinearSensor conversions:
+//
+//   1. the block of the previous tick has been filtered: its outputs are ready
+//   2. this tick's readings go to q1.15 and the next block is queued (DMA)
+//   3. the previous outputs are written back into shunt_v / vbat_v / airgap_v
+//
+// so the control groups read filtered values one SENSORS tick (100 us) late. The
+// CPU only converts and re-arms two DMA streams; the multiply-accumulates, however
+// long the filter, run on the FMAC. Filters with unity DC gain commute with the
+// affine sensor conversion, so the offsets and slopes of zeroing() still apply.
+//
+// A block still in flight when the next tick comes (about 10 us for the default
+// design) is counted in overruns and leaves that tick's readings unfiltered.
+//
+// Built with USE_FMAC_FILTERS; without it start() and exchange() do nothing.
+
+namespace FmacFilter {
+
+#ifdef USE_FMAC_FILTERS
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+inline constexpr size_t CHANNEL_COUNT = SensorChannels::COUNT;
+
+// q1.15 full scale of each kind of channel: readings beyond it are clipped
+inline constexpr float SHUNT_FULL_SCALE_A = 64.0f;
+inline constexpr float VBAT_FULL_SCALE_V = 128.0f;
+inline constexpr float AIRGAP_FULL_SCALE_M = 0.0625f;
+
+inline constexpr float full_scale(SensorChannels::Kind kind) {
+    switch (kind) {
+    case SensorChannels::Kind::SHUNT:
+        return SHUNT_FULL_SCALE_A;
+    case SensorChannels::Kind::VBAT:
+        return VBAT_FULL_SCALE_V;
+    default:
+        return AIRGAP_FULL_SCALE_M;
+    }
+}
+
+// 4-sample moving average: exact in q1.15 and unity DC gain. Fmac::biquad() and
+// Fmac::exponential() designs run the same way (as IIRs) if their memory fits.
+inline constexpr Fmac::Design DESIGN = Fmac::moving_average(4);
+inline constexpr Fmac::Program PROGRAM = Fmac::make_program(DESIGN, CHANNEL_COUNT);
+
+static_assert(
+    PROGRAM.words() <= Fmac::MEMORY_WORDS,
+    "FMAC memory too small for this design over every sensor channel"
+);
+
+using Device = LCU_Slave::FmacDeviceType;
+
+inline Device device;
+inline bool running = false;
+inline bool primed = false; // A block is in flight
+inline uint32_t overruns = 0;
+
+DMA_BUFFER inline std::array<int16_t, CHANNEL_COUNT> input_q15{};
+DMA_BUFFER inline std::array<std::array<int16_t, CHANNEL_COUNT>, 2> output_q15{};
+inline size_t writing = 0; // Output buffer of the block in flight
+
+/**
+ * @brief Reading -> q1.15 of full_scale, clipped. Non-finite readings map to 0.
+ * Not ITCM_CODE (which is noinline), like from_q15(): both inline into gather()
+ * and scatter().
+ */
+inline int16_t to_q15(float value, float full_scale) {
+    float scaled = value * (32768.0f / full_scale);
+    if (!(scaled > -32768.0f)) {
+        return scaled == scaled ? -32768 : 0;
+    }
+    return static_cast<int16_t>(std::lrintf(std::min(scaled, 32767.0f)));
+}
+
+inline float from_q15(int16_t value, float full_scale) {
+    return static_cast<float>(value) * (full_scale / 32768.0f);
+}
+
+ITCM_CODE inline void gather() {
+    SensorChannels::for_each([](size_t channel, auto kind, volatile float& field) {
+        input_q15[channel] = to_q15(field, full_scale(kind));
+    });
+}
+
+ITCM_CODE inline void scatter(const std::array<int16_t, CHANNEL_COUNT>& filtered) {
+    SensorChannels::for_each([&](size_t channel, auto kind, volatile float& field) {
+        field = from_q15(filtered[channel], full_scale(kind));
+    });
+}
+
+/**
+ * @brief Load the program on the FMAC. Until it succeeds exchange() does nothing.
+ */
+inline bool start() {
+    if constexpr (!ENABLED) {
+        return false;
+    }
+    primed = false;
+    running = device.start(PROGRAM);
+    return running;
+}
+
+/**
+ * @brief Queue this tick's readings and put the previous tick's outputs in their place.
+ */
+ITCM_CODE inline void exchange() {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    if (!running) {
+        return;
+    }
+    if (device.busy()) {
+        overruns++;
+        return;
+    }
+
+    gather();
+    size_t ready = writing;
+    writing ^= 1U;
+    device.transfer(input_q15.data(), output_q15[writing].data(), CHANNEL_COUNT);
+
+    if (primed) {
+        scatter(output_q15[ready]);
+    }
+    primed = true;
+}
+
+} // namespace FmacFilter
+
+#endif // FMAC_FILTER_HPP
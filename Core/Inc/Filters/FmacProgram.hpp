@@ -0,0 +1,170 @@
+#ifndef FMAC_PROGRAM_HPP
+#define FMAC_PROGRAM_HPP
+
+#include "C++Utilities/CppImports.hpp"
+
+// ============================================
+// FMAC filter programs
+// ============================================
+// What the FMAC (filter math accelerator) runs: one FIR or IIR filter in q1.15,
+// its coefficients and how its 256-word local memory is split between the input
+// (X1), coefficient (X2) and output (Y) buffers.
+//
+// The FMAC holds a single filter state, so several channels share it by
+// interleaving: the stream is ch0, ch1, ... ch(C-1), ch0, ... and every tap of
+// the per-channel design is spread C samples apart. Each output then only sees
+// samples of its own channel, and one configuration filters every channel with
+// no state swapping between them. The cost is memory: P = (taps - 1) * C + 1.
+//
+// Designs are in double precision and turned into q1.15 at compile time. The
+// FMAC multiplies the output by 2^R, so coefficients above 1 are stored scaled by
+// 2^-R; feedback coefficients are stored negated (the FMAC adds them).
+
+namespace Fmac {
+
+enum class Function : uint8_t { FIR, IIR };
+
+inline constexpr size_t MAX_DESIGN_TAPS = 16;
+
+// Per channel: y[n] = sum b[k] x[n-k] - sum a[k] y[n-1-k]
+struct Design {
+    Function function;
+    std::array<double, MAX_DESIGN_TAPS> b{};
+    size_t b_count = 0;
+    std::array<double, 2> a{}; // a1, a2
+    size_t a_count = 0;
+};
+
+/**
+ * @brief Average of the last taps samples.
+ */
+inline constexpr Design moving_average(size_t taps) {
+    Design design{.function = Function::FIR};
+    design.b_count = taps;
+    for (size_t k = 0; k < taps && k < MAX_DESIGN_TAPS; k++) {
+        design.b[k] = 1.0 / static_cast<double>(taps);
+    }
+    return design;
+}
+
+/**
+ * @brief y = alpha * x + (1 - alpha) * y[n-1], alpha in (0, 1].
+ */
+inline constexpr Design exponential(double alpha) {
+    Design design{.function = Function::IIR};
+    design.b[0] = alpha;
+    design.b_count = 1;
+    design.a[0] = alpha - 1.0;
+    design.a_count = 1;
+    return design;
+}
+
+/**
+ * @brief Second-order section with a0 normalized to 1.
+ */
+inline constexpr Design biquad(double b0, double b1, double b2, double a1, double a2) {
+    Design design{.function = Function::IIR};
+    design.b = {b0, b1, b2};
+    design.b_count = 3;
+    design.a = {a1, a2};
+    design.a_count = 2;
+    return design;
+}
+
+// Limits of the FMAC (RM0468)
+inline constexpr size_t MEMORY_WORDS = 256;
+inline constexpr size_t FIR_MAX_P = 127;
+inline constexpr size_t IIR_MAX_P = 64;
+inline constexpr size_t MAX_R = 7;
+
+// Room in X1 and Y beyond the filter history, so the DMA can run ahead of the filter
+inline constexpr size_t HEADROOM = 4;
+
+// Not constexpr: reaching it during constant evaluation is the compile error
+inline void design_not_supported() {}
+
+struct Program {
+    Function function;
+    size_t channels;
+    uint8_t p; // Feed-forward taps
+    uint8_t q; // Feedback taps (IIR)
+    uint8_t r; // Output gain 2^r
+    std::array<int16_t, FIR_MAX_P> b{};
+    std::array<int16_t, IIR_MAX_P> a{};
+
+    // Local memory: X2 (coefficients) first, then X1, then Y
+    constexpr size_t x2_base() const { return 0; }
+    constexpr size_t x2_size() const { return p + q; }
+    constexpr size_t x1_base() const { return x2_size(); }
+    constexpr size_t x1_size() const { return p + HEADROOM; }
+    constexpr size_t y_base() const { return x1_base() + x1_size(); }
+    constexpr size_t y_size() const { return q + HEADROOM; }
+    constexpr size_t words() const { return y_base() + y_size(); }
+};
+
+inline constexpr int16_t to_q15(double value) {
+    double scaled = value * 32768.0;
+    scaled += scaled >= 0.0 ? 0.5 : -0.5;
+    if (scaled >= 32767.0) {
+        return 32767;
+    }
+    if (scaled <= -32768.0) {
+        return -32768;
+    }
+    return static_cast<int16_t>(scaled);
+}
+
+/**
+ * @brief Interleave design over channels and quantize it. A design the FMAC cannot
+ * run that way is a compile error when evaluated in a constant expression.
+ */
+inline constexpr Program make_program(const Design& design, size_t channels) {
+    bool iir = design.function == Function::IIR;
+    size_t a_count = iir ? design.a_count : 0;
+    // IIR needs P > Q: pad the feed-forward side with zero taps
+    size_t b_count = std::max(design.b_count, a_count + 1);
+
+    size_t p = (b_count - 1) * channels + 1;
+    size_t q = a_count * channels;
+    if (channels == 0 || design.b_count == 0 || design.b_count > MAX_DESIGN_TAPS || p < 2 ||
+        p > (iir ? IIR_MAX_P : FIR_MAX_P) || (iir && q == 0)) {
+        design_not_supported();
+    }
+
+    double largest = 0.0;
+    for (size_t k = 0; k < design.b_count; k++) {
+        largest = std::max(largest, design.b[k] < 0.0 ? -design.b[k] : design.b[k]);
+    }
+    for (size_t k = 0; k < a_count; k++) {
+        largest = std::max(largest, design.a[k] < 0.0 ? -design.a[k] : design.a[k]);
+    }
+    size_t r = 0;
+    double scale = 1.0;
+    while (largest * scale > 32767.0 / 32768.0) {
+        r++;
+        scale *= 0.5;
+    }
+    if (r > MAX_R) {
+        design_not_supported();
+    }
+
+    Program program{
+        .function = design.function,
+        .channels = channels,
+        .p = static_cast<uint8_t>(p),
+        .q = static_cast<uint8_t>(q),
+        .r = static_cast<uint8_t>(r),
+    };
+    for (size_t k = 0; k < design.b_count; k++) {
+        program.b[k * channels] = to_q15(design.b[k] * scale);
+    }
+    // a[k] multiplies y[n-1-k] of the same channel, C outputs back
+    for (size_t k = 0; k < a_count; k++) {
+        program.a[(k + 1) * channels - 1] = to_q15(-design.a[k] * scale);
+    }
+    return program;
+}
+
+} // namespace Fmac
+
+#endif // FMAC_PROGRAM_HPP
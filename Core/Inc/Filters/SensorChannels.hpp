@@ -0,0 +1,40 @@
+#ifndef SENSOR_CHANNELS_HPP
+#define SENSOR_CHANNELS_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "LCU_SLAVE_Types.hpp"
+#include "Common/Placement.hpp"
+
+// ============================================
+// Sensor channels
+// ============================================
+// The converted readings the sensor filters work on, as one flat channel list:
+// shunt and vbat of LPU 0, LPU 1, ..., then airgap 0, 1, ... (28 channels in
+// 5-DOF, 3 in 1-DOF). FmacFilter and SensorFilters both use this order.
+
+namespace SensorChannels {
+
+enum class Kind : uint8_t { SHUNT, VBAT, AIRGAP };
+
+inline constexpr size_t LPU_COUNT = LCU_Slave::LpuArrayType::size();
+inline constexpr size_t AIRGAP_COUNT = LCU_Slave::AirgapArrayType::size();
+inline constexpr size_t COUNT = 2 * LPU_COUNT + AIRGAP_COUNT;
+
+/**
+ * @brief Call f(channel, kind, field) for every channel, in channel order. field is
+ * the volatile float the sensor writes (shunt_v, vbat_v or airgap_v).
+ */
+template <typename F> ITCM_CODE inline void for_each(F&& f) {
+    LCU_Slave::g_lpu_array->for_each_indexed([&](auto& lpu, size_t i) {
+        f(2 * i, Kind::SHUNT, lpu.shunt_v);
+        f(2 * i + 1, Kind::VBAT, lpu.vbat_v);
+    });
+    size_t channel = 2 * LPU_COUNT;
+    LCU_Slave::g_airgap_array->for_each([&](auto& airgap) {
+        f(channel++, Kind::AIRGAP, airgap.airgap_v);
+    });
+}
+
+} // namespace SensorChannels
+
+#endif // SENSOR_CHANNELS_HPP
@@ -0,0 +1,60 @@
+#ifndef SENSOR_FILTERS_HPP
+#define SENSOR_FILTERS_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "Common/Placement.hpp"
+#include "Filters/FilterBank.hpp"
+#include "Filters/SensorChannels.hpp"
+
+// ============================================
+// Sensor Filters (CPU)
+// ============================================
+// Filters every sensor channel (Filters/SensorChannels.hpp) in the SENSORS group,
+// right after the LinearSensor conversions: the readings are gathered into one
+// array, run through a FilterBank in a single pass and written back. No added
+// latency beyond the filter's own, and a fixed cost per tick
+// (lcu_benchmarks / ExampleBenchmark: sensor_filters_update).
+//
+// This takes the place of the per-sensor MovingAverage<10> that LPU and Airgap
+// used to carry. Built with USE_SENSOR_FILTERS; without it update() does nothing.
+// Not combined with USE_FMAC_FILTERS, which filters the same channels.
+
+namespace SensorFilters {
+
+#ifdef USE_SENSOR_FILTERS
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+#if defined(USE_SENSOR_FILTERS) && defined(USE_FMAC_FILTERS)
+#error "USE_SENSOR_FILTERS and USE_FMAC_FILTERS filter the same channels: pick one"
+#endif
+
+// Same window as the MovingAverage<10> it replaces: 1 ms at the SENSORS rate
+inline constexpr FilterConfig CONFIG = moving_average(10);
+
+using Bank = FilterBank<CONFIG, SensorChannels::COUNT>;
+
+DTCM_DATA constinit inline Bank bank{};
+DTCM_DATA constinit inline std::array<float, SensorChannels::COUNT> samples{};
+
+/**
+ * @brief Filter every channel in place, once per SENSORS tick.
+ */
+ITCM_CODE inline void update() {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    SensorChannels::for_each([](size_t channel, auto, volatile float& field) {
+        samples[channel] = field;
+    });
+    bank.update(samples);
+    SensorChannels::for_each([](size_t channel, auto, volatile float& field) {
+        field = samples[channel];
+    });
+}
+
+} // namespace SensorFilters
+
+#endif // SENSOR_FILTERS_HPP
@@ -5,9 +5,13 @@
 #include "LPU/LPU.hpp"
 #include "Airgap/Airgap.hpp"
 #include "Pinout/Pinout.hpp"
+#include "Topology/Topology.hpp"
 #include "ConfigShared.hpp"
 #include "SpiShared.hpp"
 #include "FlagsShared.hpp"
+#include "Common/Placement.hpp"
+#include "Common/EventQueue.hpp"
+#include "Filters/FmacDevice.hpp"
 
 // Forward declarations
 template <typename LPUTuple, typename EnablePinTuple> class LpuArray;
@@ -30,196 +34,90 @@ inline constexpr auto led_fault_req = ST_LIB::DigitalOutputDomain::DigitalOutput
 bool master_fault_triggered = false;
 
 inline uint32_t reset_counter = 0;
+// Master fault edges before the slave resets itself
+inline constexpr uint32_t MASTER_FAULT_RESET_COUNT = 5;
+
+// Edges are only queued here; handle_events() in the background loop acts on them
+enum class MasterFaultEvent : uint8_t { FALLING_EDGE };
+inline EventQueue<MasterFaultEvent, 8> master_fault_events;
+
+inline void system_reset() { HAL_NVIC_SystemReset(); }
+
 inline constexpr auto master_fault_req = ST_LIB::EXTIDomain::Device(
     Pinout::master_fault,
     ST_LIB::EXTIDomain::Trigger::FALLING_EDGE,
-    []() {
-        master_fault_triggered = true;
-        reset_counter++;
-        if (reset_counter >= 5) {
-            HAL_NVIC_SystemReset();
-        }
-    }
+    []() { master_fault_events.post(MasterFaultEvent::FALLING_EDGE); }
 );
 inline constexpr auto slave_fault_req =
     ST_LIB::DigitalOutputDomain::DigitalOutput(Pinout::slave_fault);
 
-// Timer and PWM configuration
-#ifdef USE_1_DOF
-inline constexpr auto pwm_positive = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm1_1, .channel = Pinout::pwm1_channel_1}
-);
-
-inline constexpr auto pwm_negative = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm1_2, .channel = Pinout::pwm1_channel_2}
-);
-
-inline constexpr auto timer = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer15},
-    pwm_positive,
-    pwm_negative
-);
-
-inline constexpr auto en_buff = ST_LIB::DigitalOutputDomain::DigitalOutput(Pinout::en_buff_1);
-
-float vbat_buffer = 0.0f;
-float shunt_buffer = 0.0f;
-float airgap_buffer = 0.0f;
-
-inline constexpr auto adc_vbat = ST_LIB::ADCDomain::ADC(Pinout::vbat_1, vbat_buffer);
-inline constexpr auto adc_shunt = ST_LIB::ADCDomain::ADC(Pinout::shunt_1, shunt_buffer);
-inline constexpr auto adc_airgap = ST_LIB::ADCDomain::ADC(Pinout::airgap_1, airgap_buffer);
-#elif defined(USE_5_DOF)
-inline constexpr auto pwm_positive_1 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm1_1, .channel = Pinout::pwm1_channel_1}
-);
-inline constexpr auto pwm_negative_1 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm1_2, .channel = Pinout::pwm1_channel_2}
-);
-inline constexpr auto timer15 = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer15},
-    pwm_positive_1,
-    pwm_negative_1
-);
-
-
-inline constexpr auto pwm_positive_2 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm2_1, .channel = Pinout::pwm2_channel_1}
-);
-inline constexpr auto pwm_negative_2 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm2_2, .channel = Pinout::pwm2_channel_2}
-);
-inline constexpr auto pwm_positive_3 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm3_1, .channel = Pinout::pwm3_channel_1}
-);
-inline constexpr auto pwm_negative_3 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm3_2, .channel = Pinout::pwm3_channel_2}
-);
-inline constexpr auto timer3 = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer3},
-    pwm_positive_2,
-    pwm_negative_2,
-    pwm_positive_3,
-    pwm_negative_3
-);
-
-inline constexpr auto pwm_positive_4 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm4_1, .channel = Pinout::pwm4_channel_1}
-);
-inline constexpr auto pwm_negative_4 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm4_2, .channel = Pinout::pwm4_channel_2}
-);
-inline constexpr auto timer8 = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer8},
-    pwm_positive_4,
-    pwm_negative_4
-);
-
-inline constexpr auto pwm_positive_5 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm5_1, .channel = Pinout::pwm5_channel_1}
-);
-inline constexpr auto pwm_negative_5 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm5_2, .channel = Pinout::pwm5_channel_2}
-);
-inline constexpr auto pwm_positive_6 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm6_1, .channel = Pinout::pwm6_channel_1}
-);
-inline constexpr auto pwm_negative_6 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm6_2, .channel = Pinout::pwm6_channel_2}
-);
-inline constexpr auto timer4 = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer4},
-    pwm_positive_5,
-    pwm_negative_5,
-    pwm_positive_6,
-    pwm_negative_6
-);
-
-inline constexpr auto pwm_positive_7 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm7_1, .channel = Pinout::pwm7_channel_1}
-);
-inline constexpr auto pwm_negative_7 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm7_2, .channel = Pinout::pwm7_channel_2}
-);
-inline constexpr auto timer17 = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer17},
-    pwm_positive_7
-);
-inline constexpr auto timer16 = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer16},
-    pwm_negative_7
-);
-
-inline constexpr auto pwm_positive_8 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm8_1, .channel = Pinout::pwm8_channel_1}
-);
-inline constexpr auto pwm_negative_8 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm8_2, .channel = Pinout::pwm8_channel_2}
-);
-inline constexpr auto timer12 = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer12},
-    pwm_positive_8,
-    pwm_negative_8
-);
+// ============================================
+// LPU / Airgap devices (generated from Topology)
+// ============================================
 
-inline constexpr auto pwm_positive_9 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm9_1, .channel = Pinout::pwm9_channel_1}
-);
-inline constexpr auto pwm_negative_9 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm9_2, .channel = Pinout::pwm9_channel_2}
-);
-inline constexpr auto pwm_positive_10 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm10_1, .channel = Pinout::pwm10_channel_1}
-);
-inline constexpr auto pwm_negative_10 = ST_LIB::TimerPin(
-    {.af = ST_LIB::TimerAF::PWM, .pin = Pinout::pwm10_2, .channel = Pinout::pwm10_channel_2}
-);
-inline constexpr auto timer1 = ST_LIB::TimerDomain::Timer(
-    {.request = Pinout::timer1},
-    pwm_positive_9,
-    pwm_negative_9,
-    pwm_positive_10,
-    pwm_negative_10
+// PWM k of the board (Topology::pwm)
+template <size_t K>
+inline constexpr auto pwm_pin = ST_LIB::TimerPin(
+    {.af = ST_LIB::TimerAF::PWM, .pin = *Topology::pwm(K).pin, .channel = Topology::pwm(K).channel}
 );
 
-inline constexpr auto en_buff_1 = ST_LIB::DigitalOutputDomain::DigitalOutput(Pinout::en_buff_1);
-inline constexpr auto en_buff_2 = ST_LIB::DigitalOutputDomain::DigitalOutput(Pinout::en_buff_2);
-inline constexpr auto en_buff_3 = ST_LIB::DigitalOutputDomain::DigitalOutput(Pinout::en_buff_3);
-inline constexpr auto en_buff_4 = ST_LIB::DigitalOutputDomain::DigitalOutput(Pinout::en_buff_4);
-inline constexpr auto en_buff_5 = ST_LIB::DigitalOutputDomain::DigitalOutput(Pinout::en_buff_5);
-
-float vbat_1_buffer = 0.0f;
-float vbat_2_buffer = 0.0f;
-float vbat_3_buffer = 0.0f;
-float vbat_4_buffer = 0.0f;
-float vbat_5_buffer = 0.0f;
-float shunt1_buffer = 0.0f;
-float shunt2_buffer = 0.0f;
-float shunt3_buffer = 0.0f;
-float shunt4_buffer = 0.0f;
-float shunt5_buffer = 0.0f;
-float airgap_1_buffer = 0.0f;
-float airgap_2_buffer = 0.0f;
-float airgap_3_buffer = 0.0f;
-float airgap_4_buffer = 0.0f;
-float airgap_5_buffer = 0.0f;
-
-inline constexpr auto adc_vbat_1 = ST_LIB::ADCDomain::ADC(Pinout::vbat_1, vbat_1_buffer);
-inline constexpr auto adc_vbat_2 = ST_LIB::ADCDomain::ADC(Pinout::vbat_2, vbat_2_buffer);
-inline constexpr auto adc_vbat_3 = ST_LIB::ADCDomain::ADC(Pinout::vbat_3, vbat_3_buffer);
-inline constexpr auto adc_vbat_4 = ST_LIB::ADCDomain::ADC(Pinout::vbat_4, vbat_4_buffer);
-inline constexpr auto adc_vbat_5 = ST_LIB::ADCDomain::ADC(Pinout::vbat_5, vbat_5_buffer);
-inline constexpr auto adc_shunt_1 = ST_LIB::ADCDomain::ADC(Pinout::shunt_1, shunt1_buffer);
-inline constexpr auto adc_shunt_2 = ST_LIB::ADCDomain::ADC(Pinout::shunt_2, shunt2_buffer);
-inline constexpr auto adc_shunt_3 = ST_LIB::ADCDomain::ADC(Pinout::shunt_3, shunt3_buffer);
-inline constexpr auto adc_shunt_4 = ST_LIB::ADCDomain::ADC(Pinout::shunt_4, shunt4_buffer);
-inline constexpr auto adc_shunt_5 = ST_LIB::ADCDomain::ADC(Pinout::shunt_5, shunt5_buffer);
-inline constexpr auto adc_airgap_1 = ST_LIB::ADCDomain::ADC(Pinout::airgap_1, airgap_1_buffer);
-inline constexpr auto adc_airgap_2 = ST_LIB::ADCDomain::ADC(Pinout::airgap_2, airgap_2_buffer);
-inline constexpr auto adc_airgap_3 = ST_LIB::ADCDomain::ADC(Pinout::airgap_3, airgap_3_buffer);
-inline constexpr auto adc_airgap_4 = ST_LIB::ADCDomain::ADC(Pinout::airgap_4, airgap_4_buffer);
-inline constexpr auto adc_airgap_5 = ST_LIB::ADCDomain::ADC(Pinout::airgap_5, airgap_5_buffer);
+template <size_t T, size_t... N> consteval auto make_timer(std::index_sequence<N...>) {
+    return ST_LIB::TimerDomain::Timer(
+        {.request = Topology::TIMERS[T]},
+        pwm_pin<Topology::pwms_of_timer<T>[N]>...
+    );
+}
+
+// Timer T of Topology::TIMERS with every PWM pin routed to it
+template <size_t T>
+inline constexpr auto timer_req =
+    make_timer<T>(std::make_index_sequence<Topology::pwms_of_timer<T>.size()>{});
+
+template <size_t E>
+inline constexpr auto enable_req =
+    ST_LIB::DigitalOutputDomain::DigitalOutput(*Topology::ENABLE_PINS[E]);
+
+DMA_BUFFER inline std::array<float, Topology::VBAT_ADCS.size()> vbat_buffers{};
+DMA_BUFFER inline std::array<float, Topology::SHUNT_ADCS.size()> shunt_buffers{};
+DMA_BUFFER inline std::array<float, Topology::AIRGAP_ADCS.size()> airgap_buffers{};
+
+template <size_t C>
+inline constexpr auto adc_vbat_req =
+    ST_LIB::ADCDomain::ADC(*Topology::VBAT_ADCS[C], vbat_buffers[C]);
+template <size_t C>
+inline constexpr auto adc_shunt_req =
+    ST_LIB::ADCDomain::ADC(*Topology::SHUNT_ADCS[C], shunt_buffers[C]);
+template <size_t C>
+inline constexpr auto adc_airgap_req =
+    ST_LIB::ADCDomain::ADC(*Topology::AIRGAP_ADCS[C], airgap_buffers[C]);
+
+// Control tick: dedicated timer, no PWM channels
+inline constexpr auto control_tick_timer =
+    ST_LIB::TimerDomain::Timer({.request = Pinout::control_timer});
+
+#ifdef STLIB_ETH
+// Ethernet: telemetry only (Telemetry/ControlTrace.hpp), same pinsets as ExampleEthernet
+#ifndef LCU_BOARD_IP
+#define LCU_BOARD_IP "192.168.1.7"
+#endif
 
+#if defined(USE_PHY_LAN8742) || defined(USE_PHY_LAN8700)
+inline constexpr auto eth_req = ST_LIB::EthernetDomain::Ethernet(
+    ST_LIB::EthernetDomain::PINSET_H10,
+    "00:80:e1:00:01:07",
+    LCU_BOARD_IP,
+    "255.255.0.0"
+);
+#elif defined(USE_PHY_KSZ8041)
+inline constexpr auto eth_req = ST_LIB::EthernetDomain::Ethernet(
+    ST_LIB::EthernetDomain::PINSET_H11,
+    "00:80:e1:00:01:07",
+    LCU_BOARD_IP,
+    "255.255.0.0"
+);
+#else
+#error "No PHY selected for Ethernet pinset selection"
+#endif
 #endif
 
 // SPI Configuration
@@ -238,117 +136,86 @@ inline constexpr auto slave_ready = ST_LIB::DigitalOutputDomain::DigitalOutput(P
 // ============================================
 // Type Aliases
 // ============================================
-using Board = ST_LIB::Board<
-    led_operational_req,
-    led_fault_req,
-    master_fault_req,
-    slave_fault_req,
-    spi_req,
-    slave_ready,
-#ifdef USE_1_DOF
-    timer,
-    en_buff,
-    adc_vbat,
-    adc_shunt,
-    adc_airgap
-#elif defined(USE_5_DOF)
-    timer15, timer3, timer8, timer4, timer17, timer16, timer12, timer1,
-    en_buff_1, en_buff_2, en_buff_3, en_buff_4, en_buff_5,
-    adc_vbat_1, adc_vbat_2, adc_vbat_3, adc_vbat_4, adc_vbat_5,
-    adc_shunt_1, adc_shunt_2, adc_shunt_3, adc_shunt_4, adc_shunt_5,
-    adc_airgap_1, adc_airgap_2, adc_airgap_3, adc_airgap_4, adc_airgap_5
+template <size_t... T, size_t... E, size_t... V, size_t... S, size_t... A>
+auto board_for(
+    std::index_sequence<T...>,
+    std::index_sequence<E...>,
+    std::index_sequence<V...>,
+    std::index_sequence<S...>,
+    std::index_sequence<A...>
+)
+    -> ST_LIB::Board<
+        led_operational_req,
+        led_fault_req,
+        master_fault_req,
+        slave_fault_req,
+        spi_req,
+        slave_ready,
+        control_tick_timer,
+#ifdef STLIB_ETH
+        eth_req,
 #endif
-    >;
-
-using EnablePinType = ST_LIB::DigitalOutputDomain::Instance;
-
-#ifdef USE_1_DOF
-using TimerWrapperType = ST_LIB::TimerWrapper<timer>;
-using PWMPositiveType = decltype(std::declval<TimerWrapperType>().template get_pwm<pwm_positive>());
-using PWMNegativeType = decltype(std::declval<TimerWrapperType>().template get_pwm<pwm_negative>());
-using LPUType = LPU<PWMPositiveType, PWMNegativeType>;
-using LpuArrayType = LpuArray<std::tuple<LPUType>, std::tuple<EnablePinType>>;
-using AirgapArrayType = AirgapArray<std::tuple<Airgap>>;
-#elif defined(USE_5_DOF)
-using TimerWrapper15Type = ST_LIB::TimerWrapper<timer15>;
-using TimerWrapper3Type = ST_LIB::TimerWrapper<timer3>;
-using TimerWrapper8Type = ST_LIB::TimerWrapper<timer8>;
-using TimerWrapper4Type = ST_LIB::TimerWrapper<timer4>;
-using TimerWrapper17Type = ST_LIB::TimerWrapper<timer17>;
-using TimerWrapper16Type = ST_LIB::TimerWrapper<timer16>;
-using TimerWrapper12Type = ST_LIB::TimerWrapper<timer12>;
-using TimerWrapper1Type = ST_LIB::TimerWrapper<timer1>;
-
-using TimerWrapperTypes = std::tuple<
-    TimerWrapper15Type,
-    TimerWrapper3Type,
-    TimerWrapper8Type,
-    TimerWrapper4Type,
-    TimerWrapper17Type,
-    TimerWrapper16Type,
-    TimerWrapper12Type,
-    TimerWrapper1Type
->;
-
-using PWMPositiveTypes = std::tuple<
-    decltype(std::declval<TimerWrapper15Type>().template get_pwm<pwm_positive_1>()),
-    decltype(std::declval<TimerWrapper3Type>().template get_pwm<pwm_positive_2>()),
-    decltype(std::declval<TimerWrapper3Type>().template get_pwm<pwm_positive_3>()),
-    decltype(std::declval<TimerWrapper8Type>().template get_pwm<pwm_positive_4>()),
-    decltype(std::declval<TimerWrapper4Type>().template get_pwm<pwm_positive_5>()),
-    decltype(std::declval<TimerWrapper4Type>().template get_pwm<pwm_positive_6>()),
-    decltype(std::declval<TimerWrapper17Type>().template get_pwm<pwm_positive_7>()),
-    decltype(std::declval<TimerWrapper12Type>().template get_pwm<pwm_positive_8>()),
-    decltype(std::declval<TimerWrapper1Type>().template get_pwm<pwm_positive_9>()),
-    decltype(std::declval<TimerWrapper1Type>().template get_pwm<pwm_positive_10>())
->;
-
-using PWMNegativeTypes = std::tuple<
-    decltype(std::declval<TimerWrapper15Type>().template get_pwm<pwm_negative_1>()),
-    decltype(std::declval<TimerWrapper3Type>().template get_pwm<pwm_negative_2>()),
-    decltype(std::declval<TimerWrapper3Type>().template get_pwm<pwm_negative_3>()),
-    decltype(std::declval<TimerWrapper8Type>().template get_pwm<pwm_negative_4>()),
-    decltype(std::declval<TimerWrapper4Type>().template get_pwm<pwm_negative_5>()),
-    decltype(std::declval<TimerWrapper4Type>().template get_pwm<pwm_negative_6>()),
-    decltype(std::declval<TimerWrapper16Type>().template get_pwm<pwm_negative_7>()),
-    decltype(std::declval<TimerWrapper12Type>().template get_pwm<pwm_negative_8>()),
-    decltype(std::declval<TimerWrapper1Type>().template get_pwm<pwm_negative_9>()),
-    decltype(std::declval<TimerWrapper1Type>().template get_pwm<pwm_negative_10>())
->; 
-
-using LPUTypes = std::tuple<
-    LPU<decltype(std::declval<TimerWrapper15Type>().template get_pwm<pwm_positive_1>()), decltype(std::declval<TimerWrapper15Type>().template get_pwm<pwm_negative_1>())>,
-    LPU<decltype(std::declval<TimerWrapper3Type>().template get_pwm<pwm_positive_2>()), decltype(std::declval<TimerWrapper3Type>().template get_pwm<pwm_negative_2>())>,
-    LPU<decltype(std::declval<TimerWrapper3Type>().template get_pwm<pwm_positive_3>()), decltype(std::declval<TimerWrapper3Type>().template get_pwm<pwm_negative_3>())>,
-    LPU<decltype(std::declval<TimerWrapper8Type>().template get_pwm<pwm_positive_4>()), decltype(std::declval<TimerWrapper8Type>().template get_pwm<pwm_negative_4>())>,
-    LPU<decltype(std::declval<TimerWrapper4Type>().template get_pwm<pwm_positive_5>()), decltype(std::declval<TimerWrapper4Type>().template get_pwm<pwm_negative_5>())>,
-    LPU<decltype(std::declval<TimerWrapper4Type>().template get_pwm<pwm_positive_6>()), decltype(std::declval<TimerWrapper4Type>().template get_pwm<pwm_negative_6>())>,
-    LPU<decltype(std::declval<TimerWrapper17Type>().template get_pwm<pwm_positive_7>()), decltype(std::declval<TimerWrapper16Type>().template get_pwm<pwm_negative_7>())>,
-    LPU<decltype(std::declval<TimerWrapper12Type>().template get_pwm<pwm_positive_8>()), decltype(std::declval<TimerWrapper12Type>().template get_pwm<pwm_negative_8>())>,
-    LPU<decltype(std::declval<TimerWrapper1Type>().template get_pwm<pwm_positive_9>()), decltype(std::declval<TimerWrapper1Type>().template get_pwm<pwm_negative_9>())>,
-    LPU<decltype(std::declval<TimerWrapper1Type>().template get_pwm<pwm_positive_10>()), decltype(std::declval<TimerWrapper1Type>().template get_pwm<pwm_negative_10>())>
->;
-
-using LpuArrayType = LpuArray<LPUTypes, std::tuple<EnablePinType, EnablePinType, EnablePinType, EnablePinType, EnablePinType>>;
-
-using AirgapArrayType = AirgapArray<std::tuple<Airgap, Airgap, Airgap, Airgap, Airgap, Airgap, Airgap, Airgap>>;
+        timer_req<T>...,
+        enable_req<E>...,
+        adc_vbat_req<V>...,
+        adc_shunt_req<S>...,
+        adc_airgap_req<A>...>;
 
-#endif
+using Board = decltype(board_for(
+    std::make_index_sequence<Topology::TIMERS.size()>{},
+    std::make_index_sequence<Topology::ENABLE_PINS.size()>{},
+    std::make_index_sequence<Topology::VBAT_ADCS.size()>{},
+    std::make_index_sequence<Topology::SHUNT_ADCS.size()>{},
+    std::make_index_sequence<Topology::AIRGAP_ADCS.size()>{}
+));
+
+using DigitalOutputType = ST_LIB::DigitalOutputDomain::Instance;
+using EnablePinType = DigitalOutputType;
+
+template <size_t T> using TimerWrapperType = ST_LIB::TimerWrapper<timer_req<T>>;
+
+template <size_t K>
+using PWMType = decltype(std::declval<TimerWrapperType<Topology::pwm(K).timer>>()
+                             .template get_pwm<pwm_pin<K>>());
+
+template <size_t I> using LPUType = LPU<PWMType<2 * I>, PWMType<2 * I + 1>>;
+
+template <typename T, size_t> using Repeat = T;
+
+template <size_t... I, size_t... E>
+auto lpu_array_for(std::index_sequence<I...>, std::index_sequence<E...>)
+    -> LpuArray<std::tuple<LPUType<I>...>, std::tuple<Repeat<EnablePinType, E>...>>;
+
+template <size_t... A>
+auto airgap_array_for(std::index_sequence<A...>) -> AirgapArray<std::tuple<Repeat<Airgap, A>...>>;
+
+using LpuArrayType = decltype(lpu_array_for(
+    std::make_index_sequence<Topology::LPU_COUNT>{},
+    std::make_index_sequence<Topology::ENABLE_PINS.size()>{}
+));
+
+using AirgapArrayType =
+    decltype(airgap_array_for(std::make_index_sequence<Topology::AIRGAP_COUNT>{}));
 
 using Frame = SystemFrame<false>; // false for Slave
 
 using SpiType = ST_LIB::SPIDomain::SPIWrapper<spi_req>;
 
+using FmacDeviceType = FmacDevice;
+
 // ============================================
 // Global Hardware Instances (extern declarations)
 // ============================================
 
 LpuArrayType* g_lpu_array;
 AirgapArrayType* g_airgap_array;
-ST_LIB::DigitalOutputDomain::Instance* g_led_operational;
-ST_LIB::DigitalOutputDomain::Instance* g_led_fault;
-ST_LIB::DigitalOutputDomain::Instance* g_slave_fault;
+DigitalOutputType* g_led_operational;
+DigitalOutputType* g_led_fault;
+DigitalOutputType* g_slave_fault;
 ST_LIB::EXTIDomain::Instance* g_master_fault;
+#ifdef STLIB_ETH
+ST_LIB::EthernetDomain::Instance* g_eth;
+#endif
 } // namespace LCU_Slave
 
 #endif // LCU_SLAVE_TYPES_HPP
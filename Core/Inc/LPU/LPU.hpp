@@ -6,29 +6,30 @@
 #include "HALAL/Services/PWM/PWM.hpp"
 #include "ST-LIB_LOW/Sensors/LinearSensor/LinearSensor.hpp"
 #include "HALAL/Services/ADC/NewADC.hpp"
-
-template <typename PWMPositive, typename PWMNegative> class LPU : public LPUBase {
+#include "Common/Placement.hpp"
+
+// Sensor turns one ADC channel into a float (LinearSensor on target); the host
+// targets in host/ substitute a mock together with the PWMs.
+template <
+    typename PWMPositive,
+    typename PWMNegative,
+    typename Sensor = LinearSensor<volatile float>>
+class LPU : public LPUBase {
 public:
+    template <typename ADCInstance>
     LPU(PWMPositive& pwm_positive,
         PWMNegative& pwm_negative,
-        ST_LIB::ADCDomain::Instance& adc_vbat_instance,
-        ST_LIB::ADCDomain::Instance& adc_shunt_instance,
+        ADCInstance& adc_vbat_instance,
+        ADCInstance& adc_shunt_instance,
         float vbat_offset,
         float vbat_slope,
         float shunt_offset,
         float shunt_slope)
         : pwm_positive(pwm_positive), pwm_negative(pwm_negative),
-          vbat_sensor(adc_vbat_instance, vbat_slope, vbat_offset, &vbat_v /*, vbat_moving_avg*/),
-          shunt_sensor(
-              adc_shunt_instance,
-              shunt_slope,
-              shunt_offset,
-              &shunt_v /*,
-              shunt_moving_avg*/
-          ) {
-    }
+          vbat_sensor(adc_vbat_instance, vbat_slope, vbat_offset, &vbat_v),
+          shunt_sensor(adc_shunt_instance, shunt_slope, shunt_offset, &shunt_v) {}
 
-    bool update() {
+    ITCM_CODE bool update() {
         if (is_fixed_vbat) {
             vbat_v = fixed_vbat;
         } else {
@@ -46,23 +47,29 @@ public:
     /**
      * @brief Set the duty cycle based on the desired output voltage and the current battery voltage
      */
-    bool set_out_voltage(float voltage) {
+    ITCM_CODE bool set_out_voltage(float voltage) {
         if (is_fixed_duty_cycle) {
             return true;
         }
-        // Avoid division by zero, but this shouldn't happen I think?
-        if (vbat_v < 0.1f) {
+        // Avoid division by zero; written so that a NaN battery voltage lands here too
+        if (!(vbat_v >= 0.1f)) {
             set_duty(0.0f);
             return false;
         }
 
-        float duty = voltage / vbat_v * 100.0f;
-        duty = std::clamp(duty, -100.0f, 100.0f);
-        set_duty(duty);
+        set_duty(voltage / vbat_v * 100.0f);
         return true;
     }
 
-    void set_duty(float duty) {
+    /**
+     * @brief Drive the bridge at duty percent, clamped to +-100. Fixed duty cycles come
+     * straight from the master frame, so a non-finite duty is treated as 0.
+     */
+    ITCM_CODE void set_duty(float duty) {
+        if (!std::isfinite(duty)) {
+            duty = 0.0f;
+        }
+        duty = std::clamp(duty, -100.0f, 100.0f);
         if (duty >= 0.0f) {
             pwm_negative.set_duty_cycle(0.0f);
             pwm_positive.set_duty_cycle(duty);
@@ -115,10 +122,9 @@ private:
     PWMPositive& pwm_positive;
     PWMNegative& pwm_negative;
 
-    // MovingAverage<10> shunt_moving_avg;
-    // MovingAverage<10> vbat_moving_avg;
-    LinearSensor<volatile float> vbat_sensor;
-    LinearSensor<volatile float> shunt_sensor;
+    // Single samples: filtering runs over every channel at once (Filters/SensorFilters.hpp)
+    Sensor vbat_sensor;
+    Sensor shunt_sensor;
 };
 
 template <typename LPUTuple, typename EnablePinTuple> class LpuArray;
@@ -149,6 +155,7 @@ public:
         disable_all();
     }
 
+    // On every enable pin, turn_off() enables its LPUs and turn_on() disables them
     void enable_all() {
         std::apply([](auto&... pin) { (pin->turn_off(), ...); }, enable_pins);
         std::apply([](auto*... lpu) { (lpu->enable(), ...); }, lpus);
@@ -167,16 +174,16 @@ public:
         if constexpr (LpuCount == 1) {
             std::get<0>(enable_pins)->turn_off();
             std::get<0>(lpus)->enable();
-            return;
-        }
-        constexpr size_t PinIndex = LpuIndex / 2;
-        std::get<PinIndex>(enable_pins)->turn_on();
+        } else {
+            constexpr size_t PinIndex = LpuIndex / 2;
+            std::get<PinIndex>(enable_pins)->turn_off();
 
-        std::get<PinIndex * 2>(lpus)->enable();
-        std::get<PinIndex * 2 + 1>(lpus)->enable();
+            std::get<PinIndex * 2>(lpus)->enable();
+            std::get<PinIndex * 2 + 1>(lpus)->enable();
+        }
     }
 
-    bool update_all() {
+    ITCM_CODE bool update_all() {
         all_ok = true;
         std::apply([&](auto&... lpu) { ((all_ok &= lpu->update()), ...); }, lpus);
         return all_ok;
@@ -184,7 +191,45 @@ public:
 
     bool is_all_ok() { return all_ok; }
 
+    static constexpr size_t size() { return LpuCount; }
+
     template <size_t Index> auto& get_lpu() { return *std::get<Index>(lpus); }
+
+    template <typename Func> void for_each(Func&& func) {
+        std::apply([&](auto*... lpu) { (func(*lpu), ...); }, lpus);
+    }
+
+    // func(lpu, index), unrolled over every LPU
+    template <typename Func> void for_each_indexed(Func&& func) {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (func(*std::get<I>(lpus), I), ...);
+        }(std::make_index_sequence<LpuCount>{});
+    }
+
+    /**
+     * @brief Enable the pairs selected in mask (bits 2p and 2p + 1 select pair p) and
+     * disable the LPUs of every other pair.
+     */
+    void apply_pair_mask(uint32_t mask) {
+        [&]<size_t... Pair>(std::index_sequence<Pair...>) {
+            (apply_pair<Pair>(mask), ...);
+        }(std::make_index_sequence<PinCount>{});
+    }
+
+private:
+    template <size_t Pair> void apply_pair(uint32_t mask) {
+        if (mask & (0x3U << (2 * Pair))) {
+            enable_pair<2 * Pair>();
+            return;
+        }
+        std::get<Pair>(enable_pins)->turn_on();
+        if constexpr (LpuCount == 1) {
+            std::get<0>(lpus)->disable();
+        } else {
+            std::get<2 * Pair>(lpus)->disable();
+            std::get<2 * Pair + 1>(lpus)->disable();
+        }
+    }
 };
 
 // Deduction guide for LpuArray
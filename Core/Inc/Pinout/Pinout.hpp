@@ -85,6 +85,9 @@ auto& pwm10_2 = ST_LIB::PE11;
 auto constexpr pwm10_channel_1 = ST_LIB::TimerChannel::CHANNEL_1;
 auto constexpr pwm10_channel_2 = ST_LIB::TimerChannel::CHANNEL_2;
 
+/* Control tick (Timer, no pins) */
+auto constexpr control_timer = ST_LIB::TimerRequest::Basic_7;
+
 /* SHUNT (ADC) */
 auto& shunt_1 = ST_LIB::PC1;
 auto& shunt_2 = ST_LIB::PC0;
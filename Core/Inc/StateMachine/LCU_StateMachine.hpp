@@ -4,6 +4,13 @@
 #include "ST-LIB_LOW/StateMachine/StateMachine.hpp"
 #include "LCU_SLAVE_Types.hpp"
 #include "Control/Control.hpp"
+#include "Control/ControlExecutive.hpp"
+#include "Control/ControlParameters.hpp"
+#include "Filters/FmacFilter.hpp"
+#include "Filters/SensorFilters.hpp"
+#include "Telemetry/ControlTrace.hpp"
+#include "Telemetry/FlightRecorder.hpp"
+#include "Telemetry/ReplayCapture.hpp"
 #include "CommunicationsShared.hpp"
 
 namespace LCU_SM {
@@ -31,10 +38,29 @@ auto check_fault = []() {
             LCU_Slave::master_fault_triggered;
 };
 
+// CURRENT_CONTROL is local to the slave: the master keeps seeing it as LEVITATING
+// (see slave_state()), so the shared SlaveState enum and wire format are unchanged.
+enum class OperationalState : uint8_t {
+    SPI_CONNECTING,
+    IDLE,
+    CURRENT_CONTROL,
+    LEVITATING,
+    FAULT,
+};
+
+inline bool levitate_requested() { return bool(command_packet->flags & CommandFlags::LEVITATE); }
+
+// A LEVITATE command is ignored while the build cannot levitate (Control::CAN_LEVITATE)
+inline bool levitation_allowed() { return Control::CAN_LEVITATE && levitate_requested(); }
+
+inline bool current_control_requested() {
+    return bool(command_packet->flags & CommandFlags::CURRENT_CONTROL);
+}
+
 static constexpr auto state_spi_connecting = make_state(
-    SlaveState::SPI_CONNECTING,
+    OperationalState::SPI_CONNECTING,
     Transition{
-        SlaveState::IDLE,
+        OperationalState::IDLE,
         []() {
 #ifdef USE_SPI_ERROR
             // Transition to IDLE if connection
@@ -45,87 +71,210 @@ static constexpr auto state_spi_connecting = make_state(
 #endif
         }
     },
-    Transition{SlaveState::FAULT, []() { return LCU_Slave::master_fault_triggered; }}
+    Transition{OperationalState::FAULT, []() { return LCU_Slave::master_fault_triggered; }}
 );
 
 static constexpr auto state_idle = make_state(
-    SlaveState::IDLE,
+    OperationalState::IDLE,
+    Transition{OperationalState::LEVITATING, levitation_allowed},
+    Transition{OperationalState::CURRENT_CONTROL, current_control_requested},
     Transition{
-        SlaveState::LEVITATING,
-        []() {
-            auto cmds = command_packet->flags;
-            return  bool(cmds & CommandFlags::LEVITATE) ||
-                    bool(cmds & CommandFlags::CURRENT_CONTROL);
-        }
+        OperationalState::FAULT,
+        check_fault
+    }
+);
+
+static constexpr auto state_current_control = make_state(
+    OperationalState::CURRENT_CONTROL,
+    Transition{OperationalState::LEVITATING, levitation_allowed},
+    Transition{
+        OperationalState::IDLE,
+        []() { return !current_control_requested(); }
     },
     Transition{
-        SlaveState::FAULT,
+        OperationalState::FAULT,
         check_fault
     }
 );
 
 static constexpr auto state_levitating = make_state(
-    SlaveState::LEVITATING,
+    OperationalState::LEVITATING,
     Transition{
-        SlaveState::IDLE,
-        []() {
-            auto cmds = command_packet->flags;
-            bool stop_requested =   !bool(cmds & CommandFlags::LEVITATE) &&
-                                    !bool(cmds & CommandFlags::CURRENT_CONTROL);
-            return stop_requested;
-        }
+        OperationalState::CURRENT_CONTROL,
+        []() { return !levitate_requested() && current_control_requested(); }
     },
     Transition{
-        SlaveState::FAULT,
+        OperationalState::IDLE,
+        []() { return !levitate_requested() && !current_control_requested(); }
+    },
+    Transition{
+        OperationalState::FAULT,
         check_fault
     }
 );
 
-static constexpr auto state_fault = make_state(SlaveState::FAULT);
+static constexpr auto state_fault = make_state(OperationalState::FAULT);
+
+// Last state seen by update(); read by the control interrupt for the flight recorder
+inline volatile OperationalState recorded_state = OperationalState::SPI_CONNECTING;
+
+inline uint16_t command_flags() { return static_cast<uint16_t>(command_packet->flags); }
+
+inline void record_transition(OperationalState from, OperationalState to) {
+    FlightRecorder::record_transition(
+        ControlExecutive::tick_count,
+        static_cast<uint8_t>(from),
+        static_cast<uint8_t>(to),
+        command_flags()
+    );
+}
+
+// ============================================
+// Control Rate Groups (timer interrupt context)
+// ============================================
+
+// Staged controller parameters go live here, before any group of the tick runs
+ITCM_CODE inline void tick_boundary_task() {
+    if (ControlParameters::swap_pending()) {
+        ReplayCapture::record_parameters(ControlParameters::active());
+    }
+}
+
+ITCM_CODE inline void sensors_task() {
+    ReplayCapture::record_adc();
+    LCU_Slave::g_lpu_array->update_all();
+    LCU_Slave::g_airgap_array->update();
+    SensorFilters::update();
+    FmacFilter::exchange();
+}
+
+ITCM_CODE inline void current_control_task() {
+    Control::current_update();
+    uint16_t current_mask = command_packet->current_control.lpu_id_bitmask;
+
+    // Bit i of the mask drives LPU i
+    LCU_Slave::g_lpu_array->for_each_indexed([&](auto& lpu, size_t i) {
+        if (current_mask & (1U << i)) {
+            lpu.set_out_voltage(Control::target_voltage[i]);
+        }
+    });
+
+    // Telemetry follows the first LPU, the one the generated loop controls
+    float target_voltage = Control::target_voltage[0];
+
+    ControlTrace::record(target_voltage);
+    ReplayCapture::record_output(static_cast<uint8_t>(recorded_state), target_voltage);
+    FlightRecorder::record_sample(
+        ControlExecutive::tick_count,
+        static_cast<uint8_t>(recorded_state),
+        command_flags(),
+        {target_voltage,
+         LCU_Slave::g_lpu_array->get_lpu<0>().shunt_v,
+         LCU_Slave::g_lpu_array->get_lpu<0>().duty_cycle,
+         LCU_Slave::g_airgap_array->get_airgap<0>().airgap_v}
+    );
+}
+
+// Only scheduled in LEVITATING, so it never wakes up just to find LEVITATE unset
+ITCM_CODE inline void levitation_control_task() {
+    float reference = command_packet->levitate.desired_distance;
+    // A NaN/inf from the master would stay in the controller states for good: hold the
+    // last step instead
+    if (!std::isfinite(reference)) {
+        return;
+    }
+    Control::levitation_update(reference);
+}
+
+inline void bind_rate_groups() {
+    using ControlExecutive::RateGroup;
+    ControlExecutive::set_boundary_task(tick_boundary_task);
+    ControlExecutive::set_task(RateGroup::SENSORS, sensors_task);
+    ControlExecutive::set_task(RateGroup::CURRENT, current_control_task);
+    ControlExecutive::set_task(RateGroup::LEVITATION, levitation_control_task);
+}
+
+// PWM stays live while moving between CURRENT_CONTROL and LEVITATING; it is only
+// switched on the way in from IDLE and on the way out to IDLE/FAULT.
+inline bool power_stage_live = false;
+
+inline void power_up() {
+    if (power_stage_live) {
+        return;
+    }
+    LCU_Slave::g_led_operational->turn_on();
+    ControlExecutive::enable(ControlExecutive::RateGroup::CURRENT);
+    LCU_Slave::g_lpu_array->enable_all();
+    power_stage_live = true;
+}
+
+inline void power_down() {
+    using ControlExecutive::RateGroup;
+    // Stop the interrupt-driven loops before tearing down what they use
+    ControlExecutive::disable(RateGroup::LEVITATION);
+    ControlExecutive::disable(RateGroup::CURRENT);
+    if (!power_stage_live) {
+        return;
+    }
+    LCU_Slave::g_lpu_array->disable_all();
+    LCU_Slave::g_led_operational->turn_off();
+    power_stage_live = false;
+}
 
-    uint32_t task_id = 0;
 static constinit auto sm_operational = []() consteval {
     auto sm = make_state_machine(
-        SlaveState::SPI_CONNECTING,
+        OperationalState::SPI_CONNECTING,
         state_spi_connecting,
         state_idle,
+        state_current_control,
         state_levitating,
         state_fault
     );
 
-    using namespace std::chrono_literals;
-
-
+    // Sensors run from boot and the controller is initialized ahead of time, so entering
+    // a control state only arms the control groups: the first step runs on the next tick,
+    // right after a fresh acquisition in that same tick.
+    sm.add_enter_action(
+        []() {
+            ControlExecutive::disable(ControlExecutive::RateGroup::LEVITATION);
+            Control::stop_levitation();
+            power_up();
+        },
+        state_current_control
+    );
 
     sm.add_enter_action(
         []() {
-            LCU_Slave::g_led_operational->turn_on();
-            Control::init();
-            LCU_Slave::g_lpu_array->enable_all();
-            task_id = Scheduler::register_task(
-                100,
-                []() {
-                    LCU_Slave::g_lpu_array->update_all();
-                    LCU_Slave::g_airgap_array->update();
-                }
-            );
+            power_up();
+            Control::start_levitation();
+            ControlExecutive::enable(ControlExecutive::RateGroup::LEVITATION);
         },
         state_levitating
     );
 
-    sm.add_exit_action(
+    sm.add_enter_action(
         []() {
-            LCU_Slave::g_led_operational->turn_off();
-            Control::deinit();
-            LCU_Slave::g_lpu_array->disable_all();
-            Scheduler::unregister_task(task_id);
+            bool was_live = power_stage_live;
+            power_down();
+            if (was_live) {
+                // Re-arm the controller here, off the entry path of the next run
+                Control::deinit();
+                Control::init();
+            }
         },
-        state_levitating
+        state_idle
     );
 
     // Enter Fault: Safe State
     sm.add_enter_action(
         []() {
+            power_down();
+            // Keep what led here: the log survives the reset ErrorHandler may cause
+            record_transition(recorded_state, OperationalState::FAULT);
+            FlightRecorder::freeze(
+                FlightRecorder::FreezeReason::FAULT_STATE,
+                static_cast<uint8_t>(OperationalState::FAULT)
+            );
             LCU_Slave::g_slave_fault->turn_on();
             LCU_Slave::g_led_fault->turn_on();
             Control::deinit();
@@ -137,47 +286,6 @@ static constinit auto sm_operational = []() consteval {
         state_fault
     );
 
-    // Levitation Control
-
-    sm.add_cyclic_action(
-        []() {
-            auto target_voltage = Control::current_update();
-            uint16_t current_mask = command_packet->current_control.lpu_id_bitmask;
-            
-#ifdef USE_1_DOF
-            // 1-DOF: Single LPU
-            if (current_mask & (1 << 0)) { LCU_Slave::g_lpu_array->get_lpu<0>().set_out_voltage(target_voltage); }
-            
-#elif defined(USE_5_DOF)
-            // 5-DOF: Apply to all 10 LPUs as specified in bitmask
-            if (current_mask & (1 << 0)) { LCU_Slave::g_lpu_array->get_lpu<0>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 1)) { LCU_Slave::g_lpu_array->get_lpu<1>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 2)) { LCU_Slave::g_lpu_array->get_lpu<2>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 3)) { LCU_Slave::g_lpu_array->get_lpu<3>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 4)) { LCU_Slave::g_lpu_array->get_lpu<4>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 5)) { LCU_Slave::g_lpu_array->get_lpu<5>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 6)) { LCU_Slave::g_lpu_array->get_lpu<6>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 7)) { LCU_Slave::g_lpu_array->get_lpu<7>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 8)) { LCU_Slave::g_lpu_array->get_lpu<8>().set_out_voltage(target_voltage); }
-            if (current_mask & (1 << 9)) { LCU_Slave::g_lpu_array->get_lpu<9>().set_out_voltage(target_voltage); }
-#endif
-        },
-        200us,
-        state_levitating
-    );
-
-    sm.add_cyclic_action(
-        []() {
-            if (bool(command_packet->flags & CommandFlags::LEVITATE)) {
-                Control::levitation_update(
-                    command_packet->levitate.desired_distance
-                );
-            }
-        },
-        1000us,
-        state_levitating
-    );
-
     return sm;
 }();
 
@@ -185,45 +293,66 @@ static constinit auto sm_operational = []() consteval {
 // Public Interface
 // ============================================
 
-inline void start() { sm_operational.start(); }
+inline void start() {
+    bind_rate_groups();
+    Control::load_gains();
+    Control::init();
+    ControlExecutive::enable(ControlExecutive::RateGroup::SENSORS);
+    sm_operational.start();
+}
+
+inline SlaveState slave_state() {
+    switch (sm_operational.get_current_state()) {
+    case OperationalState::SPI_CONNECTING:
+        return SlaveState::SPI_CONNECTING;
+    case OperationalState::IDLE:
+        return SlaveState::IDLE;
+    case OperationalState::CURRENT_CONTROL:
+    case OperationalState::LEVITATING:
+        return SlaveState::LEVITATING;
+    case OperationalState::FAULT:
+    default:
+        return SlaveState::FAULT;
+    }
+}
+
+// Time from entering a control state (from IDLE) to the first current control step
+inline uint32_t levitating_entry_latency_us() {
+    return ControlExecutive::start_latency_us(ControlExecutive::RateGroup::CURRENT);
+}
+
+// Set while ENABLE_LPU_BUFFER holds LPUs enabled outside a control state
+inline bool lpu_buffer_forced = false;
 
 inline void update() {
+    OperationalState previous = recorded_state;
     sm_operational.check_transitions();
+    OperationalState current = sm_operational.get_current_state();
+    if (current != previous) {
+        record_transition(previous, current);
+        ReplayCapture::record_transition(
+            static_cast<uint8_t>(previous),
+            static_cast<uint8_t>(current),
+            command_flags()
+        );
+        recorded_state = current;
+    }
+
+    // FAULT is final: no command may bring an LPU back up
+    if (current == OperationalState::FAULT) {
+        return;
+    }
 
     // General commands
     auto cmds = command_packet->flags;
-    static bool was_enabled = false;
     if (bool(cmds & CommandFlags::ENABLE_LPU_BUFFER)) {
         uint16_t buffer_mask = command_packet->force_enable_lpu_buffer.lpu_buffer_id_bitmask;
-        
-#ifdef USE_1_DOF
-        // 1-DOF: Single LPU pair
-        if (buffer_mask & 0x03) { LCU_Slave::g_lpu_array->enable_pair<0>(); }
-        else { LCU_Slave::g_lpu_array->get_lpu<0>().disable(); }
-        
-#elif defined(USE_5_DOF)
-        // 5-DOF: Enable LPU pairs based on bitmask
-        // Each pair corresponds to bits in the mask (0-1 -> pair 0, 2-3 -> pair 1, etc.)
-        if (buffer_mask & 0x03) { LCU_Slave::g_lpu_array->enable_pair<0>(); }  // Pair 0 (LPU 0-1)
-        else { LCU_Slave::g_lpu_array->get_lpu<0>().disable(); }
-        if (buffer_mask & 0x0C) { LCU_Slave::g_lpu_array->enable_pair<1>(); }  // Pair 1 (LPU 2-3)
-        else { LCU_Slave::g_lpu_array->get_lpu<1>().disable(); }
-        if (buffer_mask & 0x30) { LCU_Slave::g_lpu_array->enable_pair<2>(); }  // Pair 2 (LPU 4-5)
-        else { LCU_Slave::g_lpu_array->get_lpu<2>().disable(); }
-        if (buffer_mask & 0xC0) { LCU_Slave::g_lpu_array->enable_pair<3>(); }  // Pair 3 (LPU 6-7)
-        else { LCU_Slave::g_lpu_array->get_lpu<3>().disable(); }
-        if (buffer_mask & 0x300) { LCU_Slave::g_lpu_array->enable_pair<4>(); }  // Pair 4 (LPU 8-9)
-        else { LCU_Slave::g_lpu_array->get_lpu<4>().disable(); }
-#endif
-        
-        was_enabled = true;
-    } else if (was_enabled) {
-        if (sm_operational.get_current_state() == SlaveState::LEVITATING) {
-            LCU_Slave::g_lpu_array->disable_all();
-        } else {
-            LCU_Slave::g_lpu_array->disable_all();
-        }
-        was_enabled = false;
+        LCU_Slave::g_lpu_array->apply_pair_mask(buffer_mask);
+
+        lpu_buffer_forced = true;
+    } else if (lpu_buffer_forced) {
+        LCU_Slave::g_lpu_array->disable_all();
+        lpu_buffer_forced = false;
     }
 }
 
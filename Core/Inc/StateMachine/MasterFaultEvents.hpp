@@ -0,0 +1,41 @@
+#ifndef MASTER_FAULT_EVENTS_HPP
+#define MASTER_FAULT_EVENTS_HPP
+
+#include "LCU_SLAVE_Types.hpp"
+#include "Telemetry/ReplayCapture.hpp"
+
+// ============================================
+// Interrupt Events
+// ============================================
+// The background side of master_fault_events: the EXTI callback only posts an
+// edge, handle_events() acts on it. Shared with the host targets, which post edges
+// the same way and get system_reset() from the host board.
+
+namespace LCU_Slave {
+
+inline uint32_t master_fault_dropped_seen = 0;
+
+inline void on_master_fault() {
+    ReplayCapture::record_master_fault();
+    master_fault_triggered = true;
+    reset_counter++;
+    if (reset_counter >= MASTER_FAULT_RESET_COUNT) {
+        system_reset();
+    }
+}
+
+// Runs before the state machine, so an edge is seen by the transitions of the
+// same background iteration
+inline void handle_events() {
+    master_fault_events.drain([](const auto&) { on_master_fault(); });
+
+    // Edges lost to a full queue still count towards the reset
+    uint32_t dropped = master_fault_events.dropped();
+    for (; master_fault_dropped_seen != dropped; master_fault_dropped_seen++) {
+        on_master_fault();
+    }
+}
+
+} // namespace LCU_Slave
+
+#endif // MASTER_FAULT_EVENTS_HPP
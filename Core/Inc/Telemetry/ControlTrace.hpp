@@ -0,0 +1,183 @@
+#ifndef CONTROL_TRACE_HPP
+#define CONTROL_TRACE_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "LCU_SLAVE_Types.hpp"
+#include "Common/CycleCounter.hpp"
+#include "Common/Placement.hpp"
+#include "Common/SpscRing.hpp"
+#include "Control/ControlExecutive.hpp"
+#include "Control/ControlParameters.hpp"
+#include "Communications/StaticSlot.hpp"
+
+// ============================================
+// Control Trace (full-rate telemetry)
+// ============================================
+// Every current control step pushes one Sample into a lock-free ring from the
+// control interrupt. The background loop drains the ring and packs as many samples
+// as fit into each UDP datagram, so tuning traces have every step instead of the
+// Scheduler-rate DataPackets groups.
+//
+// The ring never blocks the producer: if the drain falls behind, new samples are
+// dropped and counted (the count travels in every datagram header).
+//
+// Only built with USE_ETHERNET (STLIB_ETH); without it record() compiles to nothing.
+// Host receiver: tools/control_trace_receiver.py
+
+#ifndef CONTROL_TRACE_HOST_IP
+#define CONTROL_TRACE_HOST_IP "192.168.1.9"
+#endif
+
+#ifndef CONTROL_TRACE_PORT
+#define CONTROL_TRACE_PORT 50400
+#endif
+
+namespace ControlTrace {
+
+#ifdef STLIB_ETH
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+inline constexpr size_t LPU_COUNT = LCU_Slave::LpuArrayType::size();
+inline constexpr size_t AIRGAP_COUNT = LCU_Slave::AirgapArrayType::size();
+
+struct Sample {
+    uint32_t cycles;            // DWT timestamp of the step
+    uint32_t tick;              // ControlExecutive base tick
+    uint32_t parameter_version; // ControlParameters set the step ran with
+    float target_voltage;       // Current loop output
+    std::array<float, LPU_COUNT> current;
+    std::array<float, LPU_COUNT> duty;
+    std::array<float, AIRGAP_COUNT> airgap;
+};
+
+static_assert(
+    sizeof(Sample) == sizeof(uint32_t) * 4 + sizeof(float) * (2 * LPU_COUNT + AIRGAP_COUNT),
+    "Sample is sent as raw bytes and must not have padding"
+);
+
+// 256 steps = 51 ms of CURRENT group at 200 us
+inline constexpr size_t RING_CAPACITY = 256;
+
+inline SpscRing<Sample, RING_CAPACITY> ring;
+
+/**
+ * @brief Producer: called once per current control step, from the control interrupt.
+ */
+ITCM_CODE inline void record(float target_voltage) {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    Sample sample;
+    sample.cycles = CycleCounter::now();
+    sample.tick = ControlExecutive::tick_count;
+    sample.parameter_version = ControlParameters::active_version();
+    sample.target_voltage = target_voltage;
+
+    size_t i = 0;
+    LCU_Slave::g_lpu_array->for_each([&](auto& lpu) {
+        sample.current[i] = lpu.shunt_v;
+        sample.duty[i] = lpu.duty_cycle;
+        i++;
+    });
+    i = 0;
+    LCU_Slave::g_airgap_array->for_each([&](auto& airgap) { sample.airgap[i++] = airgap.airgap_v; });
+
+    ring.push(sample);
+}
+
+#ifdef STLIB_ETH
+
+// Reserved id, next to PacketBatchFormat::BATCH_ID (0xFFFF)
+inline constexpr uint16_t TRACE_ID = 0xFFFE;
+
+// Keep every datagram inside a single Ethernet frame
+inline constexpr size_t MAX_DATAGRAM_SIZE = 1400;
+
+struct DatagramHeader {
+    uint16_t id;
+    uint8_t lpu_count;
+    uint8_t airgap_count;
+    uint16_t sample_count;
+    uint16_t sample_size;
+    uint32_t sequence;
+    uint32_t dropped; // Samples dropped by the ring since boot
+};
+
+static_assert(sizeof(DatagramHeader) == 16, "DatagramHeader is sent as raw bytes");
+
+inline constexpr size_t SAMPLES_PER_DATAGRAM =
+    (MAX_DATAGRAM_SIZE - sizeof(DatagramHeader)) / sizeof(Sample);
+inline constexpr size_t DATAGRAM_SIZE =
+    sizeof(DatagramHeader) + SAMPLES_PER_DATAGRAM * sizeof(Sample);
+
+static_assert(SAMPLES_PER_DATAGRAM > 0 && SAMPLES_PER_DATAGRAM <= RING_CAPACITY);
+
+class TraceDatagram final : public StackPacket<DATAGRAM_SIZE> {
+public:
+    TraceDatagram() : StackPacket<DATAGRAM_SIZE>(TRACE_ID) {}
+
+    // Pops the next SAMPLES_PER_DATAGRAM samples into the StackPacket's wire buffer
+    uint8_t* build() override {
+        std::array<Sample, SAMPLES_PER_DATAGRAM> samples{};
+        size_t count = ring.pop_bulk(samples.data(), samples.size());
+
+        DatagramHeader header{
+            .id = TRACE_ID,
+            .lpu_count = static_cast<uint8_t>(LPU_COUNT),
+            .airgap_count = static_cast<uint8_t>(AIRGAP_COUNT),
+            .sample_count = static_cast<uint16_t>(count),
+            .sample_size = static_cast<uint16_t>(sizeof(Sample)),
+            .sequence = sequence++,
+            .dropped = ring.dropped(),
+        };
+        uint8_t* wire = std::data(buffer);
+        std::memcpy(wire, &header, sizeof(header));
+        std::memcpy(wire + sizeof(header), samples.data(), sizeof(samples));
+        return wire;
+    }
+
+private:
+    uint32_t sequence = 0;
+};
+
+inline constexpr uint32_t DRAIN_PERIOD_US = 1000;
+// Bounds the background time spent per drain when catching up after a stall
+inline constexpr size_t MAX_DATAGRAMS_PER_DRAIN = 4;
+
+constinit inline StaticSlot<DatagramSocket> socket_slot{};
+constinit inline StaticSlot<TraceDatagram> datagram_slot{};
+inline DatagramSocket* trace_socket = nullptr;
+inline TraceDatagram* datagram = nullptr;
+
+/**
+ * @brief Consumer: sends full datagrams only, so every datagram carries SAMPLES_PER_DATAGRAM steps.
+ */
+inline void drain() {
+    for (size_t i = 0; i < MAX_DATAGRAMS_PER_DRAIN && ring.size() >= SAMPLES_PER_DATAGRAM; i++) {
+        trace_socket->send_packet(*datagram);
+    }
+}
+
+inline void start() {
+    trace_socket = socket_slot.emplace(
+        LCU_BOARD_IP,
+        CONTROL_TRACE_PORT,
+        CONTROL_TRACE_HOST_IP,
+        CONTROL_TRACE_PORT
+    );
+    datagram = datagram_slot.emplace();
+    Scheduler::register_task(DRAIN_PERIOD_US, +[]() { drain(); });
+}
+
+#else
+
+inline void start() {}
+
+#endif // STLIB_ETH
+
+} // namespace ControlTrace
+
+#endif // CONTROL_TRACE_HPP
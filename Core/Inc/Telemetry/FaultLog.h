@@ -0,0 +1,49 @@
+#ifndef FAULT_LOG_H
+#define FAULT_LOG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Rotating hard-fault log in the hard-fault flash sector (slot 0 at HF_FLASH_ADDR).
+ *
+ * Each fault appends one slot: the ST-LIB HardFaultLog at offset 0 and a
+ * FaultLogContext at FAULT_LOG_CONTEXT_OFFSET. Free slots are programmed without
+ * erasing; once every slot is used the sector is erased and the newest
+ * FAULT_LOG_SLOT_COUNT - 1 records are written back before the new one.
+ *
+ * hard_faullt_analysis.py parses this layout; keep both in sync.
+ */
+
+#define FAULT_LOG_SLOT_COUNT 16U
+#define FAULT_LOG_SLOT_SIZE 256U /* 8 flash words */
+#define FAULT_LOG_CONTEXT_OFFSET 128U
+#define FAULT_LOG_CONTEXT_MAGIC 0x58544346U /* "FCTX" */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t sequence;          /* Increments with every logged fault */
+    uint32_t uptime_ms;         /* HAL tick at the fault */
+    uint32_t cycles;            /* DWT cycle counter at the fault */
+    uint32_t state;             /* LCU_SM::OperationalState */
+    uint32_t tick_count;        /* ControlExecutive base ticks since start */
+    uint32_t last_tick_cycles;  /* ControlExecutive tick profile */
+    uint32_t worst_tick_cycles;
+    uint32_t enabled_groups;    /* Bit i set: RateGroup i was running */
+} FaultLogContext;
+
+/*
+ * Fills everything but magic and sequence. Runs on the hard-fault stack, so it
+ * must only read plain variables. The weak default in stm32h7xx_it.c leaves the
+ * context zeroed (examples without the LCU application).
+ */
+void fault_log_capture_context(FaultLogContext* context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FAULT_LOG_H */
@@ -0,0 +1,191 @@
+#ifndef FLIGHT_RECORDER_HPP
+#define FLIGHT_RECORDER_HPP
+
+#include "main.h"
+#include "ST-LIB.hpp"
+#include "C++Utilities/CppImports.hpp"
+#include "Common/CycleCounter.hpp"
+
+// ============================================
+// Flight Recorder (black box)
+// ============================================
+// Circular log of compact control samples and state transitions in a region that
+// survives reset (Core/Linker/RECORDER_placement.ld). On FAULT or a hard fault the
+// log is frozen: recording stops and the contents are kept across resets until
+// they are read out and cleared with tools/retrieve_flight_recorder.py (a power
+// loss also clears it).
+//
+// The layout below is parsed by that tool; bump VERSION when changing it.
+
+extern "C" {
+extern uint32_t _sflight_recorder;
+extern uint32_t _eflight_recorder;
+}
+
+namespace FlightRecorder {
+
+inline constexpr uint32_t MAGIC = 0x43455246; // "FREC"
+inline constexpr uint16_t VERSION = 1;
+
+// Below DmaRegion (15): the two regions never overlap
+inline constexpr uint8_t MPU_REGION = MPU_REGION_NUMBER14;
+inline constexpr uint8_t MPU_REGION_SIZE_ENCODING = MPU_REGION_SIZE_16KB;
+inline constexpr size_t REGION_SIZE = 16 * 1024;
+
+enum class RecordType : uint8_t {
+    SAMPLE = 1,     // values: target voltage, LPU 0 current, LPU 0 duty, airgap 0
+    TRANSITION = 2, // values[0]: previous state, state: new state
+    FREEZE = 3,     // values[0]: FreezeReason
+};
+
+enum class FreezeReason : uint32_t {
+    NONE = 0,
+    FAULT_STATE = 1, // Operational state machine entered FAULT
+    HARD_FAULT = 2,  // HardFault/MemManage/BusFault/UsageFault handler
+};
+
+struct Record {
+    uint32_t cycles; // DWT timestamp
+    uint32_t tick;   // ControlExecutive base tick
+    RecordType type;
+    uint8_t state;   // LCU_SM::OperationalState when recorded
+    uint16_t flags;  // CommandFlags from the master when recorded
+    std::array<float, 4> values;
+};
+
+static_assert(sizeof(Record) == 28, "Record layout is shared with the host tool");
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t record_size;
+    uint32_t capacity;
+    uint32_t write_count; // Records written since the log was armed (wraps the ring)
+    uint32_t frozen;
+    FreezeReason freeze_reason;
+    uint32_t freeze_cycles;
+    uint32_t resets_since_freeze;
+};
+
+inline constexpr size_t CAPACITY = (REGION_SIZE - sizeof(Header)) / sizeof(Record);
+
+struct Storage {
+    Header header;
+    std::array<Record, CAPACITY> records;
+};
+
+static_assert(sizeof(Storage) <= REGION_SIZE);
+static_assert(std::is_trivial_v<Storage>, "NOLOAD storage must not have constructors");
+
+// No initializer on purpose: contents are whatever survived the last reset
+__attribute__((section(".flight_recorder"))) inline Storage storage;
+
+inline bool is_frozen() { return storage.header.frozen != 0; }
+
+inline uintptr_t base() { return reinterpret_cast<uintptr_t>(&_sflight_recorder); }
+
+inline void configure_mpu() {
+    if ((reinterpret_cast<uintptr_t>(&_eflight_recorder) - base()) != REGION_SIZE ||
+        (base() % REGION_SIZE) != 0) {
+        ErrorHandler("Flight recorder region is not a single MPU-mappable block");
+        return;
+    }
+
+    MPU_Region_InitTypeDef region{};
+    region.Enable = MPU_REGION_ENABLE;
+    region.Number = MPU_REGION;
+    region.BaseAddress = static_cast<uint32_t>(base());
+    region.Size = MPU_REGION_SIZE_ENCODING;
+    region.SubRegionDisable = 0x00;
+    region.TypeExtField = MPU_TEX_LEVEL1;
+    region.AccessPermission = MPU_REGION_FULL_ACCESS;
+    region.DisableExec = MPU_INSTRUCTION_ACCESS_DISABLE;
+    region.IsShareable = MPU_ACCESS_SHAREABLE;
+    region.IsCacheable = MPU_ACCESS_NOT_CACHEABLE;
+    region.IsBufferable = MPU_ACCESS_NOT_BUFFERABLE;
+
+    HAL_MPU_Disable();
+    HAL_MPU_ConfigRegion(&region);
+    HAL_MPU_Enable(MPU_PRIVILEGED_DEFAULT);
+}
+
+/**
+ * @brief Start a fresh log, unless a frozen one survived the reset.
+ */
+inline void init() {
+    configure_mpu();
+
+    Header& header = storage.header;
+    bool valid = header.magic == MAGIC && header.version == VERSION &&
+                 header.record_size == sizeof(Record) && header.capacity == CAPACITY;
+    if (valid && header.frozen) {
+        header.resets_since_freeze++;
+        return;
+    }
+
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.record_size = sizeof(Record);
+    header.capacity = CAPACITY;
+    header.write_count = 0;
+    header.freeze_reason = FreezeReason::NONE;
+    header.freeze_cycles = 0;
+    header.resets_since_freeze = 0;
+    header.frozen = 0;
+}
+
+// Producers are the control interrupt and the background loop; the background
+// side masks interrupts around its append so the two never race on write_count.
+inline void append(const Record& record) {
+    if (storage.header.magic != MAGIC || is_frozen()) {
+        return;
+    }
+    uint32_t index = storage.header.write_count;
+    storage.records[index % CAPACITY] = record;
+    storage.header.write_count = index + 1;
+}
+
+inline void record_sample(
+    uint32_t tick,
+    uint8_t state,
+    uint16_t flags,
+    const std::array<float, 4>& values
+) {
+    append(Record{CycleCounter::now(), tick, RecordType::SAMPLE, state, flags, values});
+}
+
+inline void record_transition(uint32_t tick, uint8_t from, uint8_t to, uint16_t flags) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    append(Record{
+        CycleCounter::now(),
+        tick,
+        RecordType::TRANSITION,
+        to,
+        flags,
+        {float(from), 0.0f, 0.0f, 0.0f}
+    });
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Stop recording and keep the log. The first freeze wins; safe from fault handlers.
+ */
+inline void freeze(FreezeReason reason, uint8_t state = 0xFF) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    if (!is_frozen()) {
+        uint32_t now = CycleCounter::now();
+        append(Record{now, 0, RecordType::FREEZE, state, 0, {float(reason), 0.0f, 0.0f, 0.0f}}
+        );
+        storage.header.freeze_reason = reason;
+        storage.header.freeze_cycles = now;
+        storage.header.frozen = 1;
+        __DSB();
+    }
+    __set_PRIMASK(primask);
+}
+
+} // namespace FlightRecorder
+
+#endif // FLIGHT_RECORDER_HPP
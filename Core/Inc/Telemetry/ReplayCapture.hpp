@@ -0,0 +1,333 @@
+#ifndef REPLAY_CAPTURE_HPP
+#define REPLAY_CAPTURE_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "LCU_SLAVE_Types.hpp"
+#include "Common/Placement.hpp"
+#include "Common/SpscRing.hpp"
+#include "Control/ControlExecutive.hpp"
+#include "Control/ControlParameters.hpp"
+#include "Communications/StaticSlot.hpp"
+
+// ============================================
+// Replay Capture (record-and-replay stream)
+// ============================================
+// Records every input the slave acts on, in the order it acted on it:
+//   ADC           raw DMA buffers, as the SENSORS group reads them (control interrupt)
+//   FRAME         Frame::rx_buffer after each completed SPI transfer (background)
+//   MASTER_FAULT  a master fault edge handled by the background loop
+//   PARAMETERS    a controller parameter set, as it goes live at a tick boundary
+// and what it did with them, so a replay can be checked against the board:
+//   OUTPUT        state, enabled LPUs, target voltage and duties of a current step
+//   TRANSITION    a state machine transition
+//
+// The host replay harness (host/replay/lcu_replay.cpp) feeds the inputs through the
+// real Communications, LCU_SM and Control code and diffs its OUTPUT/TRANSITION
+// records against the captured ones.
+//
+// Interrupt and background records share one ring: background producers mask
+// interrupts around their push, so the ring still has a single producer at a time
+// and keeps the order of events across both contexts.
+//
+// Built with USE_REPLAY_CAPTURE (requires USE_ETHERNET); without it every record
+// call compiles to nothing. Host receiver: tools/replay_capture_receiver.py
+
+#ifndef REPLAY_CAPTURE_HOST_IP
+#define REPLAY_CAPTURE_HOST_IP "192.168.1.9"
+#endif
+
+#ifndef REPLAY_CAPTURE_PORT
+#define REPLAY_CAPTURE_PORT 50402
+#endif
+
+namespace ReplayCapture {
+
+#ifdef USE_REPLAY_CAPTURE
+inline constexpr bool ENABLED = true;
+#else
+inline constexpr bool ENABLED = false;
+#endif
+
+// Stream layout, shared with the receiver and the replay harness (bump VERSION on change)
+inline constexpr uint32_t MAGIC = 0x5243554C; // "LCUR"
+inline constexpr uint8_t VERSION = 1;
+
+enum class RecordType : uint8_t {
+    ADC = 1,
+    FRAME = 2,
+    MASTER_FAULT = 3,
+    OUTPUT = 4,
+    TRANSITION = 5,
+    PARAMETERS = 6, // ControlParameters::ParameterSet, header and used writes only
+    GAP = 0xFF, // Written by the receiver where records were lost
+};
+
+struct RecordHeader {
+    uint8_t type;
+    uint8_t reserved;
+    uint16_t size; // Payload bytes that follow
+    uint32_t tick; // ControlExecutive base tick when recorded
+};
+
+static_assert(sizeof(RecordHeader) == 8, "RecordHeader is sent as raw bytes");
+
+inline constexpr size_t LPU_COUNT = LCU_Slave::LpuArrayType::size();
+inline constexpr size_t VBAT_COUNT = Topology::VBAT_ADCS.size();
+inline constexpr size_t SHUNT_COUNT = Topology::SHUNT_ADCS.size();
+inline constexpr size_t AIRGAP_COUNT = Topology::AIRGAP_ADCS.size();
+inline constexpr size_t FRAME_SIZE = sizeof(LCU_Slave::Frame::rx_buffer);
+
+struct AdcPayload {
+    std::array<float, VBAT_COUNT> vbat;
+    std::array<float, SHUNT_COUNT> shunt;
+    std::array<float, AIRGAP_COUNT> airgap;
+};
+
+struct OutputPayload {
+    uint8_t state;         // LCU_SM::OperationalState
+    uint8_t reserved;
+    uint16_t enabled_mask; // Bit i: LPU i enabled
+    float target_voltage;
+    std::array<float, LPU_COUNT> duty;
+};
+
+struct TransitionPayload {
+    uint8_t from;
+    uint8_t to;
+    uint16_t command_flags;
+};
+
+static_assert(
+    sizeof(AdcPayload) == sizeof(float) * (VBAT_COUNT + SHUNT_COUNT + AIRGAP_COUNT) &&
+        sizeof(OutputPayload) == 8 + sizeof(float) * LPU_COUNT,
+    "Payloads are sent as raw bytes and must not have padding"
+);
+
+// Start of a stream file; followed by the records back to back
+struct StreamHeader {
+    uint32_t magic;
+    uint8_t version;
+    uint8_t lpu_count;
+    uint8_t vbat_count;
+    uint8_t shunt_count;
+    uint8_t airgap_count;
+    uint8_t reserved;
+    uint16_t frame_size;
+};
+
+static_assert(sizeof(StreamHeader) == 12, "StreamHeader is written as raw bytes");
+
+inline constexpr StreamHeader stream_header() {
+    return StreamHeader{
+        .magic = MAGIC,
+        .version = VERSION,
+        .lpu_count = static_cast<uint8_t>(LPU_COUNT),
+        .vbat_count = static_cast<uint8_t>(VBAT_COUNT),
+        .shunt_count = static_cast<uint8_t>(SHUNT_COUNT),
+        .airgap_count = static_cast<uint8_t>(AIRGAP_COUNT),
+        .reserved = 0,
+        .frame_size = static_cast<uint16_t>(FRAME_SIZE),
+    };
+}
+
+inline constexpr size_t MAX_PAYLOAD_SIZE = std::max({
+    sizeof(AdcPayload),
+    sizeof(OutputPayload),
+    sizeof(TransitionPayload),
+    sizeof(ControlParameters::ParameterSet),
+    FRAME_SIZE,
+});
+
+struct Record {
+    RecordHeader header;
+    std::array<uint8_t, MAX_PAYLOAD_SIZE> payload;
+};
+
+// 256 records = about 17 ms of a LEVITATING 5-DOF board (one ADC record per tick,
+// one OUTPUT record every other tick, frames on top)
+inline constexpr size_t RING_CAPACITY = 256;
+
+inline SpscRing<Record, RING_CAPACITY> ring;
+
+inline void push(RecordType type, const void* payload, size_t size) {
+    Record record;
+    record.header = RecordHeader{
+        .type = static_cast<uint8_t>(type),
+        .reserved = 0,
+        .size = static_cast<uint16_t>(size),
+        .tick = ControlExecutive::tick_count,
+    };
+    if (size > 0) {
+        std::memcpy(record.payload.data(), payload, size);
+    }
+    ring.push(record);
+}
+
+// Background producers: the control interrupt must not push in the middle
+inline void push_from_background(RecordType type, const void* payload, size_t size) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    push(type, payload, size);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Called by the SENSORS group right before it converts the DMA buffers.
+ */
+ITCM_CODE inline void record_adc() {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    AdcPayload payload;
+    std::ranges::copy(LCU_Slave::vbat_buffers, payload.vbat.begin());
+    std::ranges::copy(LCU_Slave::shunt_buffers, payload.shunt.begin());
+    std::ranges::copy(LCU_Slave::airgap_buffers, payload.airgap.begin());
+    push(RecordType::ADC, &payload, sizeof(payload));
+}
+
+/**
+ * @brief Called by the current control step with what it just applied.
+ */
+ITCM_CODE inline void record_output(uint8_t state, float target_voltage) {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    OutputPayload payload{};
+    payload.state = state;
+    payload.target_voltage = target_voltage;
+    LCU_Slave::g_lpu_array->for_each_indexed([&](auto& lpu, size_t i) {
+        payload.duty[i] = lpu.duty_cycle;
+        if (lpu.is_enabled) {
+            payload.enabled_mask |= static_cast<uint16_t>(1U << i);
+        }
+    });
+    push(RecordType::OUTPUT, &payload, sizeof(payload));
+}
+
+/**
+ * @brief Called at the tick boundary that applied set, before the tick's ADC record.
+ */
+ITCM_CODE inline void record_parameters(const ControlParameters::ParameterSet& set) {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    push(RecordType::PARAMETERS, &set, ControlParameters::used_size(set));
+}
+
+/**
+ * @brief Called by Communications once a transfer has filled Frame::rx_buffer.
+ */
+inline void record_frame() {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    push_from_background(RecordType::FRAME, LCU_Slave::Frame::rx_buffer, FRAME_SIZE);
+}
+
+inline void record_master_fault() {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    push_from_background(RecordType::MASTER_FAULT, nullptr, 0);
+}
+
+inline void record_transition(uint8_t from, uint8_t to, uint16_t command_flags) {
+    if constexpr (!ENABLED) {
+        return;
+    }
+    TransitionPayload payload{.from = from, .to = to, .command_flags = command_flags};
+    push_from_background(RecordType::TRANSITION, &payload, sizeof(payload));
+}
+
+#if defined(USE_REPLAY_CAPTURE) && defined(STLIB_ETH)
+
+// Reserved id, next to the benchmark report (0xFFFD)
+inline constexpr uint16_t CAPTURE_ID = 0xFFFC;
+
+// Keep every datagram inside a single Ethernet frame
+inline constexpr size_t MAX_DATAGRAM_SIZE = 1400;
+
+struct DatagramHeader {
+    uint16_t id;
+    uint16_t record_count;
+    uint32_t sequence;
+    uint32_t dropped;    // Records dropped by the ring since boot
+    StreamHeader stream;  // So every datagram can start a stream file
+};
+
+static_assert(sizeof(DatagramHeader) == 24, "DatagramHeader is sent as raw bytes");
+
+// Records are packed back to back at their real size; the count assumes the largest
+inline constexpr size_t RECORDS_PER_DATAGRAM =
+    (MAX_DATAGRAM_SIZE - sizeof(DatagramHeader)) / (sizeof(RecordHeader) + MAX_PAYLOAD_SIZE);
+inline constexpr size_t DATAGRAM_SIZE = MAX_DATAGRAM_SIZE;
+
+static_assert(RECORDS_PER_DATAGRAM > 0 && RECORDS_PER_DATAGRAM <= RING_CAPACITY);
+
+class CaptureDatagram final : public StackPacket<DATAGRAM_SIZE> {
+public:
+    CaptureDatagram() : StackPacket<DATAGRAM_SIZE>(CAPTURE_ID) {}
+
+    // Pops the next RECORDS_PER_DATAGRAM records into the wire buffer
+    uint8_t* build() override {
+        size_t offset = sizeof(DatagramHeader);
+        uint16_t count = 0;
+        Record record;
+        while (count < RECORDS_PER_DATAGRAM && ring.pop(record)) {
+            size_t size = sizeof(RecordHeader) + record.header.size;
+            std::memcpy(buffer.data() + offset, &record, size);
+            offset += size;
+            count++;
+        }
+
+        DatagramHeader header{
+            .id = CAPTURE_ID,
+            .record_count = count,
+            .sequence = sequence++,
+            .dropped = ring.dropped(),
+            .stream = stream_header(),
+        };
+        std::memcpy(buffer.data(), &header, sizeof(header));
+        return buffer.data();
+    }
+
+private:
+    uint32_t sequence = 0;
+    std::array<uint8_t, DATAGRAM_SIZE> buffer{};
+};
+
+inline constexpr uint32_t DRAIN_PERIOD_US = 1000;
+// A LEVITATING 5-DOF board produces about one datagram per millisecond
+inline constexpr size_t MAX_DATAGRAMS_PER_DRAIN = 8;
+
+constinit inline StaticSlot<DatagramSocket> socket_slot{};
+constinit inline StaticSlot<CaptureDatagram> datagram_slot{};
+inline DatagramSocket* capture_socket = nullptr;
+inline CaptureDatagram* datagram = nullptr;
+
+inline void drain() {
+    for (size_t i = 0; i < MAX_DATAGRAMS_PER_DRAIN && ring.size() >= RECORDS_PER_DATAGRAM; i++) {
+        capture_socket->send_packet(*datagram);
+    }
+}
+
+inline void start() {
+    capture_socket = socket_slot.emplace(
+        LCU_BOARD_IP,
+        REPLAY_CAPTURE_PORT,
+        REPLAY_CAPTURE_HOST_IP,
+        REPLAY_CAPTURE_PORT
+    );
+    datagram = datagram_slot.emplace();
+    Scheduler::register_task(DRAIN_PERIOD_US, +[]() { drain(); });
+}
+
+#else
+
+inline void start() {}
+
+#endif // USE_REPLAY_CAPTURE && STLIB_ETH
+
+} // namespace ReplayCapture
+
+#endif // REPLAY_CAPTURE_HPP
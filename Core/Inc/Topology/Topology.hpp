@@ -0,0 +1,297 @@
+#ifndef TOPOLOGY_HPP
+#define TOPOLOGY_HPP
+
+#include "C++Utilities/CppImports.hpp"
+#include "ST-LIB.hpp"
+#include "Pinout/Pinout.hpp"
+
+// ============================================
+// Board Topology
+// ============================================
+// The single description of what is wired where for the selected DOF build.
+// LCU_SLAVE_Types.hpp generates every timer, PWM pin, ADC channel and enable pin
+// device, the Board and the LPU/Airgap array types from these tables, and
+// LCU_Slave::init() builds the instances with index sequences. Every LPU and
+// airgap also carries its placement on the vehicle, from which MimoLevitation
+// builds its matrices. A new configuration only needs new tables here.
+//
+// Rules checked below:
+// - LPU i is switched by enable pin i / 2 (two LPUs per buffer), or a lone
+//   LPU has its own pin (1-DOF).
+// - Table indices are in range.
+// - Airgaps that read the same ADC channel have the same placement: the channel
+//   is one sensor, so it cannot face two directions or sit in two places.
+
+namespace Topology {
+
+using Pin = std::remove_reference_t<decltype(ST_LIB::PE5)>;
+
+struct PwmSpec {
+    Pin* pin;
+    ST_LIB::TimerChannel channel;
+    size_t timer; // Index in TIMERS
+};
+
+enum class Direction : uint8_t {
+    VERTICAL, // Faces the rail above it
+    LATERAL,  // Faces the rail on its side (the sign of y)
+};
+
+// Position in the body frame: x forward, y left, from the center of mass
+struct Placement {
+    Direction direction;
+    float x_m;
+    float y_m;
+
+    constexpr bool operator==(const Placement&) const = default;
+};
+
+struct LpuSpec {
+    PwmSpec positive;
+    PwmSpec negative;
+    size_t vbat;   // Index in VBAT_ADCS
+    size_t shunt;  // Index in SHUNT_ADCS
+    size_t enable; // Index in ENABLE_PINS
+    Placement placement;
+};
+
+struct AirgapSpec {
+    size_t adc; // Index in AIRGAP_ADCS
+    Placement placement;
+};
+
+#ifdef USE_1_DOF
+
+inline constexpr size_t DOF = 1;
+
+inline constexpr std::array TIMERS = {Pinout::timer15};
+
+inline constexpr std::array<Pin*, 1> ENABLE_PINS = {&Pinout::en_buff_1};
+
+inline constexpr std::array<Pin*, 1> VBAT_ADCS = {&Pinout::vbat_1};
+inline constexpr std::array<Pin*, 1> SHUNT_ADCS = {&Pinout::shunt_1};
+inline constexpr std::array<Pin*, 1> AIRGAP_ADCS = {&Pinout::airgap_1};
+
+inline constexpr std::array<LpuSpec, 1> LPUS = {{
+    {.positive = {&Pinout::pwm1_1, Pinout::pwm1_channel_1, 0},
+     .negative = {&Pinout::pwm1_2, Pinout::pwm1_channel_2, 0},
+     .vbat = 0,
+     .shunt = 0,
+     .enable = 0,
+     .placement = {Direction::VERTICAL, 0.0f, 0.0f}},
+}};
+
+inline constexpr std::array<AirgapSpec, 1> AIRGAPS = {{
+    {0, {Direction::VERTICAL, 0.0f, 0.0f}},
+}};
+
+#elif defined(USE_5_DOF)
+
+inline constexpr size_t DOF = 5;
+
+inline constexpr std::array TIMERS = {
+    Pinout::timer15, // 0
+    Pinout::timer3,  // 1
+    Pinout::timer8,  // 2
+    Pinout::timer4,  // 3
+    Pinout::timer17, // 4
+    Pinout::timer16, // 5
+    Pinout::timer12, // 6
+    Pinout::timer1,  // 7
+};
+
+inline constexpr std::array<Pin*, 5> ENABLE_PINS = {
+    &Pinout::en_buff_1,
+    &Pinout::en_buff_2,
+    &Pinout::en_buff_3,
+    &Pinout::en_buff_4,
+    &Pinout::en_buff_5,
+};
+
+inline constexpr std::array<Pin*, 5> VBAT_ADCS = {
+    &Pinout::vbat_1,
+    &Pinout::vbat_2,
+    &Pinout::vbat_3,
+    &Pinout::vbat_4,
+    &Pinout::vbat_5,
+};
+inline constexpr std::array<Pin*, 5> SHUNT_ADCS = {
+    &Pinout::shunt_1,
+    &Pinout::shunt_2,
+    &Pinout::shunt_3,
+    &Pinout::shunt_4,
+    &Pinout::shunt_5,
+};
+inline constexpr std::array<Pin*, 5> AIRGAP_ADCS = {
+    &Pinout::airgap_1,
+    &Pinout::airgap_2,
+    &Pinout::airgap_3,
+    &Pinout::airgap_4,
+    &Pinout::airgap_5,
+};
+
+// LPUs 6-10 share the sensing channels of LPUs 1-5
+inline constexpr std::array<LpuSpec, 10> LPUS = {{
+    {.positive = {&Pinout::pwm1_1, Pinout::pwm1_channel_1, 0},
+     .negative = {&Pinout::pwm1_2, Pinout::pwm1_channel_2, 0},
+     .vbat = 0,
+     .shunt = 0,
+     .enable = 0,
+     .placement = {Direction::VERTICAL, 0.60f, 0.20f}},
+    {.positive = {&Pinout::pwm2_1, Pinout::pwm2_channel_1, 1},
+     .negative = {&Pinout::pwm2_2, Pinout::pwm2_channel_2, 1},
+     .vbat = 1,
+     .shunt = 1,
+     .enable = 0,
+     .placement = {Direction::VERTICAL, 0.60f, -0.20f}},
+    {.positive = {&Pinout::pwm3_1, Pinout::pwm3_channel_1, 1},
+     .negative = {&Pinout::pwm3_2, Pinout::pwm3_channel_2, 1},
+     .vbat = 2,
+     .shunt = 2,
+     .enable = 1,
+     .placement = {Direction::VERTICAL, 0.0f, 0.20f}},
+    {.positive = {&Pinout::pwm4_1, Pinout::pwm4_channel_1, 2},
+     .negative = {&Pinout::pwm4_2, Pinout::pwm4_channel_2, 2},
+     .vbat = 3,
+     .shunt = 3,
+     .enable = 1,
+     .placement = {Direction::VERTICAL, 0.0f, -0.20f}},
+    {.positive = {&Pinout::pwm5_1, Pinout::pwm5_channel_1, 3},
+     .negative = {&Pinout::pwm5_2, Pinout::pwm5_channel_2, 3},
+     .vbat = 4,
+     .shunt = 4,
+     .enable = 2,
+     .placement = {Direction::VERTICAL, -0.60f, 0.20f}},
+    {.positive = {&Pinout::pwm6_1, Pinout::pwm6_channel_1, 3},
+     .negative = {&Pinout::pwm6_2, Pinout::pwm6_channel_2, 3},
+     .vbat = 0,
+     .shunt = 0,
+     .enable = 2,
+     .placement = {Direction::VERTICAL, -0.60f, -0.20f}},
+    {.positive = {&Pinout::pwm7_1, Pinout::pwm7_channel_1, 4},
+     .negative = {&Pinout::pwm7_2, Pinout::pwm7_channel_2, 5},
+     .vbat = 1,
+     .shunt = 1,
+     .enable = 3,
+     .placement = {Direction::LATERAL, 0.60f, 0.25f}},
+    {.positive = {&Pinout::pwm8_1, Pinout::pwm8_channel_1, 6},
+     .negative = {&Pinout::pwm8_2, Pinout::pwm8_channel_2, 6},
+     .vbat = 2,
+     .shunt = 2,
+     .enable = 3,
+     .placement = {Direction::LATERAL, 0.60f, -0.25f}},
+    {.positive = {&Pinout::pwm9_1, Pinout::pwm9_channel_1, 7},
+     .negative = {&Pinout::pwm9_2, Pinout::pwm9_channel_2, 7},
+     .vbat = 3,
+     .shunt = 3,
+     .enable = 4,
+     .placement = {Direction::LATERAL, -0.60f, 0.25f}},
+    {.positive = {&Pinout::pwm10_1, Pinout::pwm10_channel_1, 7},
+     .negative = {&Pinout::pwm10_2, Pinout::pwm10_channel_2, 7},
+     .vbat = 4,
+     .shunt = 4,
+     .enable = 4,
+     .placement = {Direction::LATERAL, -0.60f, -0.25f}},
+}};
+
+// Nominal placements, not measured on the vehicle (MimoLevitation::GEOMETRY_MEASURED).
+// Airgaps 6-8 share the channels of airgaps 1-3, so they are those sensors again:
+// only 4 vertical gaps and 1 lateral gap are measured.
+inline constexpr std::array<AirgapSpec, 8> AIRGAPS = {{
+    {0, {Direction::VERTICAL, 0.60f, 0.20f}},
+    {1, {Direction::VERTICAL, 0.60f, -0.20f}},
+    {2, {Direction::VERTICAL, -0.60f, 0.20f}},
+    {3, {Direction::VERTICAL, -0.60f, -0.20f}},
+    {4, {Direction::LATERAL, 0.60f, 0.25f}},
+    {0, {Direction::VERTICAL, 0.60f, 0.20f}},
+    {1, {Direction::VERTICAL, 0.60f, -0.20f}},
+    {2, {Direction::VERTICAL, -0.60f, 0.20f}},
+}};
+
+#endif
+
+inline constexpr size_t LPU_COUNT = LPUS.size();
+inline constexpr size_t AIRGAP_COUNT = AIRGAPS.size();
+
+// LPU index -> enable pin index, as LpuArray switches them
+inline constexpr size_t pair_of(size_t lpu) { return LPU_COUNT == 1 ? 0 : lpu / 2; }
+
+consteval bool is_valid() {
+    for (size_t i = 0; i < LPU_COUNT; i++) {
+        const LpuSpec& lpu = LPUS[i];
+        if (lpu.positive.timer >= TIMERS.size() || lpu.negative.timer >= TIMERS.size() ||
+            lpu.vbat >= VBAT_ADCS.size() || lpu.shunt >= SHUNT_ADCS.size() ||
+            lpu.enable >= ENABLE_PINS.size() || lpu.enable != pair_of(i)) {
+            return false;
+        }
+    }
+    for (const AirgapSpec& airgap : AIRGAPS) {
+        if (airgap.adc >= AIRGAP_ADCS.size()) {
+            return false;
+        }
+    }
+    return LPU_COUNT == 1 ? ENABLE_PINS.size() == 1 : LPU_COUNT == 2 * ENABLE_PINS.size();
+}
+
+static_assert(is_valid(), "Topology tables are inconsistent");
+
+consteval bool airgap_aliases_agree() {
+    for (size_t i = 0; i < AIRGAP_COUNT; i++) {
+        for (size_t j = i + 1; j < AIRGAP_COUNT; j++) {
+            if (AIRGAPS[i].adc == AIRGAPS[j].adc &&
+                AIRGAPS[i].placement != AIRGAPS[j].placement) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static_assert(
+    airgap_aliases_agree(),
+    "Airgaps that share an ADC channel must have the same placement"
+);
+
+// ============================================
+// Compile-time queries for the generators
+// ============================================
+
+// PWM k of the board: LPU k / 2, positive when k is even
+inline constexpr size_t PWM_COUNT = 2 * LPU_COUNT;
+
+inline constexpr const PwmSpec& pwm(size_t k) {
+    return k % 2 == 0 ? LPUS[k / 2].positive : LPUS[k / 2].negative;
+}
+
+inline constexpr size_t pwm_count_of_timer(size_t timer) {
+    size_t count = 0;
+    for (size_t k = 0; k < PWM_COUNT; k++) {
+        count += pwm(k).timer == timer ? 1 : 0;
+    }
+    return count;
+}
+
+// Board PWM indices owned by a timer, in table order
+template <size_t Timer> inline constexpr auto pwms_of_timer = [] {
+    std::array<size_t, pwm_count_of_timer(Timer)> indices{};
+    size_t n = 0;
+    for (size_t k = 0; k < PWM_COUNT; k++) {
+        if (pwm(k).timer == Timer) {
+            indices[n++] = k;
+        }
+    }
+    return indices;
+}();
+
+/**
+ * @brief Call func(std::integral_constant<size_t, I>{}) for I in [0, N), fully unrolled.
+ */
+template <size_t N, typename Func> constexpr void unroll(Func&& func) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+        (func(std::integral_constant<size_t, I>{}), ...);
+    }(std::make_index_sequence<N>{});
+}
+
+} // namespace Topology
+
+#endif // TOPOLOGY_HPP
@@ -0,0 +1,351 @@
+#ifdef EXAMPLE_BENCHMARK
+
+#include "main.h"
+#include "ST-LIB.hpp"
+#include "LCU_SLAVE.hpp"
+
+extern "C" {
+#include "control.h"
+}
+
+// ============================================
+// On-target microbenchmarks
+// ============================================
+// Runs the control hot paths in tight loops on the real board and times every
+// call with the DWT cycle counter, once with the I/D-caches on and once with
+// them off. Interrupts are masked while a loop runs, so the figures are the
+// paths alone. The PWM outputs are never turned on: set_out_voltage() only
+// writes compare registers.
+//
+// Results land in benchmark_report, which tools/retrieve_benchmark_report.py
+// reads over SWD. With USE_ETHERNET the report is also sent as one UDP datagram
+// per second to BENCHMARK_HOST_IP:BENCHMARK_PORT.
+//
+// Build with a release preset; Debug figures say nothing about the firmware:
+//   tools/build-example.sh --example benchmark --preset board-release
+
+#ifndef BENCHMARK_HOST_IP
+#define BENCHMARK_HOST_IP "192.168.1.9"
+#endif
+
+#ifndef BENCHMARK_PORT
+#define BENCHMARK_PORT 50401
+#endif
+
+namespace Benchmark {
+
+// Report layout, parsed by tools/retrieve_benchmark_report.py (bump VERSION on change)
+inline constexpr uint32_t MAGIC = 0x48434E42; // "BNCH"
+inline constexpr uint16_t VERSION = 1;
+inline constexpr size_t CAPACITY = 32; // Report stays within one UDP datagram
+inline constexpr size_t NAME_SIZE = 24;
+
+inline constexpr uint32_t WARMUP = 16;
+inline constexpr uint32_t ITERATIONS = 1000;
+
+enum Flags : uint32_t {
+    FLAG_TCM = 1U << 0,       // Built with USE_TCM
+    FLAG_5_DOF = 1U << 1,     // Built with USE_5_DOF
+    FLAG_TRUNCATED = 1U << 2, // The suite measured more than CAPACITY entries
+};
+
+struct Entry {
+    char name[NAME_SIZE];
+    uint32_t cache; // 1: I- and D-cache on, 0: both off
+    uint32_t iterations;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint32_t mean_cycles;
+};
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_size;
+    uint16_t entry_count;
+    uint16_t capacity;
+    uint32_t core_clock_hz;
+    uint32_t flags;
+    uint32_t overhead_cycles; // Timing overhead already subtracted from every entry
+    uint32_t complete;        // 1 once every entry is written
+    uint32_t reserved;
+};
+
+struct Report {
+    Header header;
+    std::array<Entry, CAPACITY> entries;
+};
+
+static_assert(sizeof(Entry) == 44 && sizeof(Header) == 32, "Layout is shared with the host tool");
+
+} // namespace Benchmark
+
+// Fixed symbol name so the host tool finds it in the ELF
+extern "C" __attribute__((used, aligned(32))) Benchmark::Report benchmark_report{};
+
+namespace Benchmark {
+
+inline void barrier() { __asm volatile("" ::: "memory"); }
+
+inline uint32_t overhead = 0;
+
+// Smallest time the empty measurement takes; subtracted from every sample
+inline void calibrate() {
+    uint32_t best = UINT32_MAX;
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        uint32_t start = CycleCounter::now();
+        barrier();
+        uint32_t cycles = CycleCounter::elapsed(start);
+        best = std::min(best, cycles);
+    }
+    overhead = best;
+}
+
+template <typename Body> void measure(const char* name, bool cache, Body&& body) {
+    Header& header = benchmark_report.header;
+    if (header.entry_count >= CAPACITY) {
+        header.flags |= FLAG_TRUNCATED;
+        return;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    for (uint32_t i = 0; i < WARMUP; i++) {
+        body();
+        barrier();
+    }
+
+    uint32_t min_cycles = UINT32_MAX;
+    uint32_t max_cycles = 0;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < ITERATIONS; i++) {
+        uint32_t start = CycleCounter::now();
+        body();
+        barrier();
+        uint32_t cycles = CycleCounter::elapsed(start);
+        cycles = cycles > overhead ? cycles - overhead : 0;
+        min_cycles = std::min(min_cycles, cycles);
+        max_cycles = std::max(max_cycles, cycles);
+        total += cycles;
+    }
+
+    __set_PRIMASK(primask);
+
+    Entry& entry = benchmark_report.entries[header.entry_count];
+    entry = Entry{};
+    std::strncpy(entry.name, name, NAME_SIZE - 1);
+    entry.cache = cache ? 1 : 0;
+    entry.iterations = ITERATIONS;
+    entry.min_cycles = min_cycles;
+    entry.max_cycles = max_cycles;
+    entry.mean_cycles = static_cast<uint32_t>(total / ITERATIONS);
+    header.entry_count++;
+}
+
+// ============================================
+// Board bring-up (LCU_Slave::init() without the control tick and SPI)
+// ============================================
+
+inline void init_board() {
+    using namespace LCU_Slave;
+
+    DmaRegion::clear();
+    Board::init();
+    DmaRegion::configure_mpu();
+    FlightRecorder::init();
+
+    g_led_operational = &Board::instance_of<led_operational_req>();
+    g_led_fault = &Board::instance_of<led_fault_req>();
+    g_slave_fault = &Board::instance_of<slave_fault_req>();
+#ifdef STLIB_ETH
+    g_eth = &Board::instance_of<eth_req>();
+#endif
+
+    Topology::unroll<Topology::TIMERS.size()>([](auto timer) {
+        timer_instance<decltype(timer)::value>().set_pwm_frequency(PWM_FREQUENCY_HZ);
+    });
+
+    g_lpu_array = &lpu_array_instance(
+        std::make_index_sequence<Topology::LPU_COUNT>{},
+        std::make_index_sequence<Topology::ENABLE_PINS.size()>{}
+    );
+    g_airgap_array = &airgap_array_instance(std::make_index_sequence<Topology::AIRGAP_COUNT>{});
+
+    Communications::init();
+#ifdef USE_SPI_ERROR
+    Communications::spi_error_counter = 0; // Let the state machine leave SPI_CONNECTING
+#endif
+    LCU_SM::start();
+    LCU_SM::update(); // SPI_CONNECTING -> IDLE
+
+    init_frame(
+        std::make_index_sequence<Topology::LPU_COUNT>{},
+        std::make_index_sequence<Topology::AIRGAP_COUNT>{}
+    );
+
+    CycleCounter::init();
+}
+
+// ============================================
+// Suite
+// ============================================
+
+inline void run_suite(bool cache) {
+    using namespace LCU_Slave;
+
+    auto& lpu = g_lpu_array->get_lpu<0>();
+
+    static constexpr std::array<float, 8> voltages = {
+        -40.0f, -20.0f, -5.0f, 0.0f, 5.0f, 12.0f, 24.0f, 40.0f
+    };
+    size_t next_voltage = 0;
+    measure("lpu_set_out_voltage", cache, [&] {
+        lpu.set_out_voltage(voltages[next_voltage]);
+        next_voltage = (next_voltage + 1) % voltages.size();
+    });
+    measure("lpu_array_update_all", cache, [] { g_lpu_array->update_all(); });
+    measure("airgap_array_update", cache, [] { g_airgap_array->update(); });
+
+    // CPU side of the FMAC sensor filters, every channel to q1.15 and back; a block
+    // adds the re-arm of two DMA streams on top
+    measure("fmac_convert", cache, [] {
+        FmacFilter::gather();
+        FmacFilter::scatter(FmacFilter::input_q15);
+    });
+
+    // CPU sensor filter banks over every channel: the cheapest type at the window of
+    // the old MovingAverage<10>, and the most expensive one
+    static FilterBank<moving_average(10), SensorChannels::COUNT> average_bank;
+    // 2nd-order Butterworth low-pass, 1 kHz at the 10 kHz SENSORS rate
+    static FilterBank<biquad(0.067455f, 0.134911f, 0.067455f, -1.142981f, 0.412802f),
+                      SensorChannels::COUNT>
+        biquad_bank;
+    static std::array<float, SensorChannels::COUNT> samples{};
+    measure("filter_bank_average10", cache, [] { average_bank.update(samples); });
+    measure("filter_bank_biquad", cache, [] { biquad_bank.update(samples); });
+
+    control_U.corriente_real = 1.0f;
+    control_U.Gap = 0.018f;
+    control_U.Referencia = 0.020f;
+    measure("control_step0", cache, [] { control_step0(); });
+    measure("control_step1", cache, [] { control_step1(); });
+
+    // Native current PI (Control/Pid.hpp) next to control_step0, then the current
+    // loop as this build compiles it (native with USE_NATIVE_CURRENT_CONTROL or in 5-DOF)
+    static Control::CurrentPi current_pi;
+    static volatile float voltage = 0.0f;
+    measure("current_pi_step", cache, [&] {
+        voltage = current_pi.step(Control::current_gains, 0.0f, lpu.shunt_v);
+    });
+    measure("control_current_update", cache, [] { Control::current_update(); });
+
+    // The outer loop as this build compiles it (MimoLevitation in 5-DOF)
+    measure("control_levitation_update", cache, [] { Control::levitation_update(0.020f); });
+
+    // Airgap gain schedule lookup, on a table the size tools/create_look_up_table.cpp writes
+    static constexpr auto gain_table = make_gain_table<33, 3>(0.010f, 0.030f, [](float gap) {
+        return std::array<float, 3>{1e5f * gap, 1e6f * gap, 2e3f * gap};
+    });
+    static volatile float scheduled_gain = 0.0f;
+    measure("gain_table_lookup", cache, [] {
+        scheduled_gain = gain_table.at(g_airgap_array->get_airgap<0>().airgap_v)[0];
+    });
+
+    static volatile bool frame_flag = false;
+    measure("frame_update_tx", cache, [] { Frame::update_tx(&frame_flag); });
+    measure("frame_update_rx", cache, [] { Frame::update_rx(&frame_flag); });
+
+    measure("sm_check_transitions", cache, [] { LCU_SM::sm_operational.check_transitions(); });
+    measure("lcu_sm_update", cache, [] { LCU_SM::update(); });
+}
+
+inline void run() {
+    Header& header = benchmark_report.header;
+    header = Header{};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.entry_size = sizeof(Entry);
+    header.capacity = CAPACITY;
+    header.core_clock_hz = SystemCoreClock;
+#ifdef USE_TCM
+    header.flags |= FLAG_TCM;
+#endif
+#ifdef USE_5_DOF
+    header.flags |= FLAG_5_DOF;
+#endif
+
+    calibrate();
+    header.overhead_cycles = overhead;
+
+    SCB_EnableICache();
+    SCB_EnableDCache();
+    run_suite(true);
+
+    SCB_DisableDCache(); // Cleans it first
+    SCB_DisableICache();
+    run_suite(false);
+
+    header.complete = 1;
+    // The debugger reads memory, not the cache
+    DCache::clean(&benchmark_report, sizeof(benchmark_report));
+}
+
+#ifdef STLIB_ETH
+
+// Reserved id, next to ControlTrace::TRACE_ID (0xFFFE)
+inline constexpr uint16_t REPORT_ID = 0xFFFD;
+
+// id + padding, then the report exactly as in memory
+inline constexpr size_t DATAGRAM_SIZE = 4 + sizeof(Report);
+
+class ReportDatagram final : public StackPacket<DATAGRAM_SIZE> {
+public:
+    ReportDatagram() : StackPacket<DATAGRAM_SIZE>(REPORT_ID) {}
+
+    uint8_t* build() override {
+        uint8_t* wire = std::data(buffer);
+        std::memcpy(wire, &id, sizeof(id));
+        std::memcpy(wire + 4, &benchmark_report, sizeof(Report));
+        return wire;
+    }
+};
+
+constinit inline StaticSlot<DatagramSocket> socket_slot{};
+constinit inline StaticSlot<ReportDatagram> datagram_slot{};
+
+inline void start_reporting() {
+    static DatagramSocket* report_socket =
+        socket_slot.emplace(LCU_BOARD_IP, BENCHMARK_PORT, BENCHMARK_HOST_IP, BENCHMARK_PORT);
+    static ReportDatagram* datagram = datagram_slot.emplace();
+    Scheduler::register_task(1'000'000, +[]() { report_socket->send_packet(*datagram); });
+}
+
+#endif // STLIB_ETH
+
+} // namespace Benchmark
+
+int main(void) {
+    Hard_fault_check();
+
+    Benchmark::init_board();
+    Benchmark::run();
+
+    // Leave the caches as the application runs them
+    SCB_EnableICache();
+    SCB_EnableDCache();
+
+#ifdef STLIB_ETH
+    Scheduler::start();
+    Benchmark::start_reporting();
+#endif
+
+    while (1) {
+#ifdef STLIB_ETH
+        LCU_Slave::g_eth->update();
+        Scheduler::update();
+#endif
+    }
+}
+
+#endif // EXAMPLE_BENCHMARK
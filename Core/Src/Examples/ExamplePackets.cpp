@@ -211,8 +211,8 @@ int main(void) {
             if (OrderPackets::control_test_tcp != nullptr &&
                 !OrderPackets::control_test_tcp->is_connected() &&
                 !OrderPackets::control_test_tcp->is_listening()) {
-                delete OrderPackets::control_test_tcp;
-                OrderPackets::control_test_tcp = new ServerSocket(BOARD_IP, 41000);
+                OrderPackets::control_test_tcp =
+                    OrderPackets::control_test_tcp_slot.emplace(BOARD_IP, 41000);
             }
         }
 
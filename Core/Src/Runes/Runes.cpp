@@ -110,12 +110,14 @@ unordered_map<uint32_t, uint32_t> I2C::available_speed_frequencies = {{100, 0x60
  *					   FMAC
  ***********************************************/
 
-#ifdef HAL_FMAC_MODULE_ENABLED
+// With USE_FMAC_FILTERS the FMAC and its streams belong to FmacFilter (Filters/FmacDevice.hpp)
+#if defined(HAL_FMAC_MODULE_ENABLED) && !defined(USE_FMAC_FILTERS)
 
+// Same streams as HAL_FMAC_MspInit (stm32h7xx_hal_msp.c)
 MultiplierAccelerator::FMACInstance MultiplierAccelerator::Instance = {
     .hfmac = &hfmac,
     .dma_preload = DMA::Stream::DMA2Stream0,
-    .dma_read = DMA::Stream::DMA2Stream1,
-    .dma_write = DMA::Stream::DMA2Stream2,
+    .dma_read = DMA::Stream::DMA2Stream2,
+    .dma_write = DMA::Stream::DMA2Stream1,
 };
 #endif
@@ -0,0 +1,6 @@
+#include "Telemetry/FlightRecorder.hpp"
+
+// C entry point for the fault handlers in stm32h7xx_it.c
+extern "C" void flight_recorder_freeze_hard_fault(void) {
+    FlightRecorder::freeze(FlightRecorder::FreezeReason::HARD_FAULT);
+}
@@ -0,0 +1,40 @@
+#ifdef USE_TCM
+
+#include "main.h"
+#include <cstring>
+
+// Symbols from Core/Linker/TCM_placement.ld
+extern "C" {
+extern uint32_t _sitcm_text;
+extern uint32_t _eitcm_text;
+extern uint32_t _siitcm_text;
+extern uint32_t _sdtcm_data;
+extern uint32_t _edtcm_data;
+extern uint32_t _sidtcm_data;
+extern uint32_t _sdtcm_bss;
+extern uint32_t _edtcm_bss;
+}
+
+// Runs from __libc_init_array before every other constructor, so static objects
+// placed in TCM are loaded before anything can construct or call into them.
+__attribute__((constructor(101))) static void tcm_init() {
+    std::memcpy(
+        &_sitcm_text,
+        &_siitcm_text,
+        reinterpret_cast<uintptr_t>(&_eitcm_text) - reinterpret_cast<uintptr_t>(&_sitcm_text)
+    );
+    std::memcpy(
+        &_sdtcm_data,
+        &_sidtcm_data,
+        reinterpret_cast<uintptr_t>(&_edtcm_data) - reinterpret_cast<uintptr_t>(&_sdtcm_data)
+    );
+    std::memset(
+        &_sdtcm_bss,
+        0,
+        reinterpret_cast<uintptr_t>(&_edtcm_bss) - reinterpret_cast<uintptr_t>(&_sdtcm_bss)
+    );
+    __DSB();
+    __ISB();
+}
+
+#endif // USE_TCM
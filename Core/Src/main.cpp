@@ -1,5 +1,12 @@
 #include "main.h"
+#include "ST-LIB.hpp"
+
+// Example builds (an EXAMPLE_* define, see CMakeLists.txt) bring their own main()
+// and, when they need it, their own copy of the LCU application.
+#ifndef EXAMPLE_SELECTED
+
 #include "LCU_SLAVE.hpp"
+#include "Telemetry/FaultLog.h"
 
 int main(void) {
     Hard_fault_check();
@@ -11,6 +18,24 @@ int main(void) {
     }
 }
 
+// Called from the fault handler: only plain reads, no HAL calls besides the tick
+extern "C" void fault_log_capture_context(FaultLogContext* context) {
+    context->uptime_ms = HAL_GetTick();
+    context->cycles = CycleCounter::now();
+    context->state = static_cast<uint32_t>(LCU_SM::recorded_state);
+    context->tick_count = ControlExecutive::tick_count;
+    context->last_tick_cycles = ControlExecutive::last_tick_cycles;
+    context->worst_tick_cycles = ControlExecutive::worst_tick_cycles;
+    context->enabled_groups = 0;
+    for (size_t i = 0; i < ControlExecutive::RATE_GROUP_COUNT; i++) {
+        if (ControlExecutive::enabled[i]) {
+            context->enabled_groups |= 1U << i;
+        }
+    }
+}
+
+#endif // EXAMPLE_SELECTED
+
 void Error_Handler(void) {
     ErrorHandler("HAL error handler triggered");
     while (1) {
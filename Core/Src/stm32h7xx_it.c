@@ -22,6 +22,7 @@
 #include "stm32h7xx_it.h"
 #include "stm32h7xx_hal.h"
 #include "HALAL/HardFault/HardfaultTrace.h"
+#include "Telemetry/FaultLog.h"
 #include <string.h>
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
@@ -78,10 +79,15 @@ Externs for calltrace
 */
 extern uint32_t _stext;
 extern uint32_t _etext;
+#ifdef USE_TCM
+extern uint32_t _sitcm_text;
+extern uint32_t _eitcm_text;
+#endif
 extern uint32_t _sstack;
 extern uint32_t _estack;
 extern uint32_t _hf_stack_start;
 extern uint32_t _hf_stack_end;
+extern void flight_recorder_freeze_hard_fault(void);
 /* USER CODE BEGIN EV */
 
 /* USER CODE END EV */
@@ -113,17 +119,52 @@ extern uint32_t _hf_stack_end;
 // create the space for the hardfault section in the flash
 __attribute__((section(".hardfault_log"))) volatile uint32_t hard_fault[128];
 
-void hardfault_flash_write(
-    uint32_t addr_hard_fault,
-    const void* data_hard_fault,
-    size_t len_hard_fault,
-    uint32_t addr_metadata,
-    const void* data_metadata,
-    size_t len_metadata
-) {
-    HAL_FLASH_Unlock();
+_Static_assert(
+    sizeof(HardFaultLog) <= FAULT_LOG_CONTEXT_OFFSET,
+    "HardFaultLog overlaps the fault log context"
+);
+_Static_assert(
+    FAULT_LOG_CONTEXT_OFFSET + sizeof(FaultLogContext) <= FAULT_LOG_SLOT_SIZE,
+    "FaultLogContext does not fit in a fault log slot"
+);
+
+// The handler runs on the small hard-fault stack, so the slot being written and the
+// records kept across an erase live in .bss instead
+static uint8_t fault_log_slot[FAULT_LOG_SLOT_SIZE] __attribute__((aligned(32)));
+static uint8_t fault_log_backup[(FAULT_LOG_SLOT_COUNT - 1) * FAULT_LOG_SLOT_SIZE]
+    __attribute__((aligned(32)));
+
+__attribute__((weak)) void fault_log_capture_context(FaultLogContext* context) { (void)context; }
+
+static uint32_t fault_log_slot_address(uint32_t slot) {
+    return HF_FLASH_ADDR + slot * FAULT_LOG_SLOT_SIZE;
+}
 
-    // Erase sector
+// Slots written before the context existed count as the oldest records
+static uint32_t fault_log_slot_sequence(uint32_t slot) {
+    volatile FaultLogContext* context =
+        (volatile FaultLogContext*)(fault_log_slot_address(slot) + FAULT_LOG_CONTEXT_OFFSET);
+    return context->magic == FAULT_LOG_CONTEXT_MAGIC ? context->sequence : 0;
+}
+
+static uint8_t hardfault_flash_program(uint32_t address, const void* data, size_t len) {
+    size_t offset, copy_len;
+    uint8_t block[32];
+    offset = 0;
+    while (offset < len) {
+        memset(block, 0xFF, sizeof(block));
+        copy_len = (len - offset) > 32 ? 32 : (len - offset);
+        memcpy(block, (uint8_t*)data + offset, copy_len);
+        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_FLASHWORD, address + offset, (uintptr_t)block) !=
+            HAL_OK) {
+            return 0;
+        }
+        offset += 32;
+    }
+    return 1;
+}
+
+static uint8_t hardfault_flash_erase(void) {
     FLASH_EraseInitTypeDef erase;
     uint32_t sector_error = 0;
     erase.TypeErase = FLASH_TYPEERASE_SECTORS;
@@ -131,56 +172,81 @@ void hardfault_flash_write(
     erase.Sector = FLASH_SECTOR_6;
     erase.NbSectors = 1;
     erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+    return HAL_FLASHEx_Erase(&erase, &sector_error) == HAL_OK;
+}
 
-    if (HAL_FLASHEx_Erase(&erase, &sector_error) != HAL_OK) {
-        HAL_FLASH_Lock();
-        return;
-    }
-
-    size_t offset, copy_len;
-    uint8_t block[32];
-
-    offset = 0;
-    while (offset < len_hard_fault) {
-        memset(block, 0xFF, sizeof(block));
-        copy_len = (len_hard_fault - offset) > 32 ? 32 : (len_hard_fault - offset);
-        memcpy(block, (uint8_t*)data_hard_fault + offset, copy_len);
-
-        if (HAL_FLASH_Program(
-                FLASH_TYPEPROGRAM_FLASHWORD,
-                addr_hard_fault + offset,
-                (uintptr_t)block
-            ) != HAL_OK) {
-            HAL_FLASH_Lock();
-            return;
+// Appends fault_log_slot to the rotating log. Only erases (and rewrites the
+// metadata that shares the sector) when every slot is in use.
+static void fault_log_write(void) {
+    uint32_t free_slot = FAULT_LOG_SLOT_COUNT;
+    uint32_t oldest_slot = 0;
+    uint32_t oldest_sequence = 0xFFFFFFFF;
+    uint32_t newest_sequence = 0;
+    for (uint32_t slot = 0; slot < FAULT_LOG_SLOT_COUNT; slot++) {
+        if (*(volatile uint32_t*)fault_log_slot_address(slot) == 0xFFFFFFFF) {
+            if (free_slot == FAULT_LOG_SLOT_COUNT) {
+                free_slot = slot;
+            }
+            continue;
+        }
+        uint32_t sequence = fault_log_slot_sequence(slot);
+        if (sequence < oldest_sequence) {
+            oldest_sequence = sequence;
+            oldest_slot = slot;
+        }
+        if (sequence > newest_sequence) {
+            newest_sequence = sequence;
         }
-        offset += 32;
     }
+    ((FaultLogContext*)(fault_log_slot + FAULT_LOG_CONTEXT_OFFSET))->sequence = newest_sequence + 1;
 
-    offset = 0;
-    while (offset < len_metadata) {
-        memset(block, 0xFF, sizeof(block));
-        copy_len = (len_metadata - offset) > 32 ? 32 : (len_metadata - offset);
-        memcpy(block, (uint8_t*)data_metadata + offset, copy_len);
-
-        if (HAL_FLASH_Program(
-                FLASH_TYPEPROGRAM_FLASHWORD,
-                addr_metadata + offset,
-                (uintptr_t)block
-            ) != HAL_OK) {
-            HAL_FLASH_Lock();
-            return;
+    HAL_FLASH_Unlock();
+    if (free_slot < FAULT_LOG_SLOT_COUNT) {
+        hardfault_flash_program(
+            fault_log_slot_address(free_slot),
+            fault_log_slot,
+            FAULT_LOG_SLOT_SIZE
+        );
+    } else {
+        uint32_t kept = 0;
+        for (uint32_t slot = 0; slot < FAULT_LOG_SLOT_COUNT; slot++) {
+            if (slot == oldest_slot) {
+                continue;
+            }
+            memcpy(
+                fault_log_backup + kept * FAULT_LOG_SLOT_SIZE,
+                (void*)fault_log_slot_address(slot),
+                FAULT_LOG_SLOT_SIZE
+            );
+            kept++;
+        }
+        volatile uint8_t metadata_buffer[0x100];
+        memcpy((void*)metadata_buffer, (void*)METADATA_FLASH_ADDR, 0x100);
+
+        if (hardfault_flash_erase() &&
+            hardfault_flash_program(HF_FLASH_ADDR, fault_log_backup, sizeof(fault_log_backup)) &&
+            hardfault_flash_program(
+                fault_log_slot_address(FAULT_LOG_SLOT_COUNT - 1),
+                fault_log_slot,
+                FAULT_LOG_SLOT_SIZE
+            )) {
+            hardfault_flash_program(
+                METADATA_FLASH_ADDR,
+                (void*)metadata_buffer,
+                sizeof(metadata_buffer)
+            );
         }
-        offset += 32;
     }
-
     SCB_InvalidateICache();
     SCB_InvalidateDCache();
-
     HAL_FLASH_Lock();
 }
 static uint8_t is_valid_pc(uint32_t pc) {
     pc &= ~1U; // Thumb
+#ifdef USE_TCM
+    if (pc >= (uint32_t)&_sitcm_text && pc < (uint32_t)&_eitcm_text)
+        return 1;
+#endif
     return (pc >= (uint32_t)&_stext && pc < (uint32_t)&_etext);
 }
 __attribute__((optimize("O0"))) static void
@@ -205,6 +271,9 @@ __attribute__((noreturn, optimize("O0"))) void my_fault_handler_c(sContextStateF
     volatile uint32_t real_fault_pc = frame->return_address & ~1;
     volatile HardFaultLog log_hard_fault;
 
+    // Stop the flight recorder first so the samples before the fault are kept
+    flight_recorder_freeze_hard_fault();
+
     volatile uint32_t* cfsr = (volatile uint32_t*)0xE000ED28;
     // keep the log in the estructure
     log_hard_fault.HF_flag = HF_FLAG_VALUE;
@@ -264,17 +333,15 @@ __attribute__((noreturn, optimize("O0"))) void my_fault_handler_c(sContextStateF
     if (usage_fault | bus_fault) {
         scan_call_stack(frame, &log_hard_fault);
     }
-    volatile uint8_t metadata_buffer[0x100];
-    memcpy(metadata_buffer, (void*)METADATA_FLASH_ADDR, 0x100);
     // write log hard fault
-    hardfault_flash_write(
-        HF_FLASH_ADDR,
-        (uint8_t*)&log_hard_fault,
-        sizeof(log_hard_fault),
-        METADATA_FLASH_ADDR,
-        &metadata_buffer,
-        sizeof(metadata_buffer)
-    );
+    FaultLogContext context;
+    memset(&context, 0, sizeof(context));
+    fault_log_capture_context(&context);
+    context.magic = FAULT_LOG_CONTEXT_MAGIC;
+    memset(fault_log_slot, 0xFF, sizeof(fault_log_slot));
+    memcpy(fault_log_slot, (void*)&log_hard_fault, sizeof(log_hard_fault));
+    memcpy(fault_log_slot + FAULT_LOG_CONTEXT_OFFSET, &context, sizeof(context));
+    fault_log_write();
 
     // halt only when a debugger is attached, otherwise reboot.
     volatile uint32_t* dhcsr = (volatile uint32_t*)0xE000EDF0;
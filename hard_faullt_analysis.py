@@ -1,243 +1,350 @@
-import subprocess
-import struct
-import re
+#!/usr/bin/env python3
+"""Decode the rotating hard-fault log (Core/Inc/Telemetry/FaultLog.h).
+
+The whole log is read with a single SWD upload, the ELF symbol table is loaded
+once, and every address of every record is resolved with one addr2line call.
+Prints a readable report and optionally writes a machine-readable JSON one.
+"""
+from __future__ import annotations
+
+import argparse
+import bisect
+import json
 import os
+import struct
+import subprocess
+import sys
+from pathlib import Path
+
 HF_FLASH_ADDR = 0x080C0000
-HF_FLASH_ADDR_STRING = "0x080C000"
 ELF_FILE = "out/build/latest.elf"
+DUMP_FILE = Path("hard_fault_log.bin")
 
+HF_FLAG_VALUE = 0xFF00FF00
 CALL_TRACE_MAX_DEPTH = 16
-def read_flash():
+
+# Core/Inc/Telemetry/FaultLog.h
+SLOT_COUNT = 16
+SLOT_SIZE = 256
+CONTEXT_OFFSET = 128
+CONTEXT_MAGIC = 0x58544346
+
+HARD_FAULT_LOG = struct.Struct("<28I")
+CONTEXT = struct.Struct("<9I")
+
+REGISTERS = ["r0", "r1", "r2", "r3", "r12", "lr", "pc", "psr"]
+# LCU_SM::OperationalState
+STATES = ["SPI_CONNECTING", "IDLE", "CURRENT_CONTROL", "LEVITATING", "FAULT"]
+# ControlExecutive::RateGroup
+RATE_GROUPS = ["SENSORS", "CURRENT", "LEVITATION"]
+
+MEMORY_FAULT_BITS = [
+    (0x20, "MLSPERR", "Floating Point Unit lazy state preservation error"),
+    (0x10, "MSTKERR", "Stack error on entry to exception"),
+    (0x08, "MUNSTKERR", "Stack error on return from exception"),
+    (0x02, "DACCVIOL", "Data access violation (NULL pointer or invalid access)"),
+    (0x01, "IACCVIOL", "Instruction access violation"),
+]
+BUS_FAULT_BITS = [
+    (0x20, "LSPERR", "Floating Point Unit lazy state preservation error"),
+    (0x10, "STKERR", "Stack error on entry to exception"),
+    (0x08, "UNSTKERR", "Stack error on return from exception"),
+    (0x04, "IMPRECISERR", "Bus fault address imprecise (don't trust the call stack)"),
+    (0x01, "PRECISERR", "Precise data bus error"),
+]
+USAGE_FAULT_BITS = [
+    (0x0200, "DIVBYZERO", "Division by zero"),
+    (0x0100, "UNALIGNED", "Unaligned memory access"),
+    (0x0008, "NOCP", "Accessed FPU when not present"),
+    (0x0004, "INVPC", "Invalid Program Counter(PC) load"),
+    (0x0002, "INVSTATE", "Invalid processor state"),
+    (0x0001, "UNDEFINSTR", "Undefined instruction"),
+]
+
+
+# --------------------------
+# Reading the log
+# --------------------------
+def read_flash() -> bytes:
+    if DUMP_FILE.exists():
+        DUMP_FILE.unlink()
+    cmd = [
+        "STM32_Programmer_CLI",
+        "-c", "port=SWD",
+        "-u", hex(HF_FLASH_ADDR), hex(SLOT_COUNT * SLOT_SIZE), str(DUMP_FILE),
+    ]
     try:
-        cmd = [
-            "STM32_Programmer_CLI",
-            "-c", "port=SWD",
-            "-r32", hex(HF_FLASH_ADDR), "112"
-        ]
-        out = subprocess.check_output(cmd, text=True)
-        return out
+        subprocess.run(cmd, check=True, stdout=subprocess.DEVNULL)
     except subprocess.CalledProcessError as e:
-        print("Stop debugging to check fault analysis!!!")
-        print(f"Error: {e}")
-        return None
-    except FileNotFoundError:
-        print("STM32_Programmer_CLI not found. Make sure it is installed and in PATH.")
-        return None
-def decode_cfsr_memory(cfsr, fault_addr):
-    memory_fault = cfsr & 0xFF
-    if memory_fault == 0:
-        return 0
-    print("\nMemory Fault (MMFSR):")
-    if memory_fault & 0b10000000:
-        print(f"  MMARVALID: Memory fault address valid -> 0x{fault_addr:08X}")
-        if fault_addr in (0xFFFFFFFF, 0x00000000):
-            print("  Fault address is invalid / unmapped memory")
-        else:
-            mem_info = addr2line(fault_addr)
-            print_code_context(mem_info)
-    if memory_fault & 0b00100000:
-        print("  MLSPERR : Floating Point Unit lazy state preservation error")
-    if memory_fault & 0b00010000:
-        print("  MSTKERR : Stack error on entry to exception")
-    if memory_fault & 0b00001000:
-        print("  MUNSTKERR : Stack error on return from exception")
-    if memory_fault & 0b00000010:
-        print("  DACCVIOL : Data access violation (NULL pointer or invalid access)")
-    if memory_fault & 0b00000001:
-        print("  IACCVIOL : Instruction access violation")
-    return 1
+        raise RuntimeError(f"Stop debugging to check fault analysis!!! ({e})") from e
+    except FileNotFoundError as e:
+        raise RuntimeError("STM32_Programmer_CLI not found. Make sure it is installed and in PATH.") from e
+    return DUMP_FILE.read_bytes()
+
+
+def parse_slots(raw: bytes) -> list[dict]:
+    """Return the valid records, oldest first."""
+    records = []
+    for slot in range(min(SLOT_COUNT, len(raw) // SLOT_SIZE)):
+        base = slot * SLOT_SIZE
+        words = HARD_FAULT_LOG.unpack_from(raw, base)
+        if words[0] != HF_FLAG_VALUE:
+            continue
+        record = {
+            "slot": slot,
+            "registers": dict(zip(REGISTERS, words[1:9])),
+            "cfsr": words[9],
+            "fault_addr": words[10],
+            "calltrace": [pc for pc in words[12:12 + min(words[11], CALL_TRACE_MAX_DEPTH)]],
+            "sequence": 0,
+            "context": None,
+        }
+        magic, sequence, uptime_ms, cycles, state, tick_count, last_tick, worst_tick, groups = (
+            CONTEXT.unpack_from(raw, base + CONTEXT_OFFSET)
+        )
+        if magic == CONTEXT_MAGIC:
+            record["sequence"] = sequence
+            record["context"] = {
+                "uptime_ms": uptime_ms,
+                "cycles": cycles,
+                "state": STATES[state] if state < len(STATES) else str(state),
+                "tick_count": tick_count,
+                "last_tick_cycles": last_tick,
+                "worst_tick_cycles": worst_tick,
+                "enabled_groups": [name for i, name in enumerate(RATE_GROUPS) if groups & (1 << i)],
+            }
+        records.append(record)
+    records.sort(key=lambda record: record["sequence"])
+    return records
+
 
 # --------------------------
-# Decode Bus Fault (BFSR)
+# Symbol resolution
 # --------------------------
-def decode_cfsr_bus(cfsr, fault_addr):
-    bus_fault = (cfsr & 0x0000FF00) >> 8
-    if bus_fault == 0:
-        return 0
-    print("\nBus Fault (BFSR):")
-    if bus_fault & 0b10000000:
-        if(bus_fault & 0b00000001):
-            print(f"  BFARVALID : Bus fault address valid -> 0x{fault_addr:08X}")
-    if bus_fault & 0b00000100:
-        print(f"\033[91m Bus fault address imprecise\033[0m (DON'T LOOK CALL STACK)")
-
-    if bus_fault & 0b00100000:
-        print("  LSPERR : Floating Point Unit lazy state preservation error")
-    if bus_fault & 0b00010000:
-        print("  STKERR : Stack error on entry to exception")
-    if bus_fault & 0b00001000:
-        print("  UNSTKERR : Stack error on return from exception")
-    return 2
+class Symbolizer:
+    """Loads the ELF symbol table once and resolves source lines in batches."""
+
+    def __init__(self, elf: str):
+        self.elf = elf
+        self.starts: list[int] = []
+        self.symbols: list[tuple[int, int, str]] = []
+        self.lines: dict[int, tuple[str, str]] = {}
+        output = subprocess.check_output(
+            ["arm-none-eabi-nm", "-C", "-n", "-S", "--defined-only", elf], text=True
+        )
+        for line in output.splitlines():
+            fields = line.split(maxsplit=3)
+            if len(fields) != 4 or fields[2] not in "tTwW":
+                continue
+            address, size = int(fields[0], 16) & ~1, int(fields[1], 16)
+            self.starts.append(address)
+            self.symbols.append((address, size, fields[3]))
+
+    def symbol(self, address: int) -> str | None:
+        index = bisect.bisect_right(self.starts, address) - 1
+        if index < 0:
+            return None
+        start, size, name = self.symbols[index]
+        if address >= start + max(size, 1):
+            return None
+        return f"{name}+0x{address - start:x}"
+
+    def resolve_lines(self, addresses) -> None:
+        """One addr2line process for every address not resolved yet."""
+        pending = sorted({address for address in addresses if address not in self.lines})
+        if not pending:
+            return
+        output = subprocess.check_output(
+            ["arm-none-eabi-addr2line", "-e", self.elf, "-f", "-C", *(hex(a) for a in pending)],
+            text=True,
+        ).splitlines()
+        for i, address in enumerate(pending):
+            self.lines[address] = (output[2 * i].strip(), output[2 * i + 1].strip())
+
+    def location(self, address: int) -> dict:
+        function, file_line = self.lines.get(address, ("??", "??:0"))
+        path, _, line = file_line.rpartition(":")
+        location = {"address": f"0x{address:08X}", "symbol": self.symbol(address), "function": function}
+        if path and path != "??":
+            location["file"] = path
+            location["line"] = int(line) if line.isdigit() else None
+        return location
+
+
+def record_addresses(record: dict) -> list[int]:
+    addresses = [record["registers"]["pc"], record["registers"]["lr"] & ~1]
+    # Return addresses point after the call: look at the branch itself
+    addresses += [(pc & ~1) - 4 for pc in record["calltrace"]]
+    if fault_address_valid(record["cfsr"]) and record["fault_addr"] not in (0, 0xFFFFFFFF):
+        addresses.append(record["fault_addr"])
+    return addresses
+
 
 # --------------------------
-# Decode Usage Fault (UFSR)
+# Decoding
 # --------------------------
-def decode_cfsr_usage(cfsr):
-    usage_fault = (cfsr & 0xFFFF0000) >> 16
-    if usage_fault == 0:
-        return 0
-    print("\nUsage Fault (UFSR):")
-    if usage_fault & 0x0200:
-        print("  DIVBYZERO : Division by zero")
-    if usage_fault & 0x0100:
-        print("  UNALIGNED : Unaligned memory access")
-    if usage_fault & 0x0008:
-        print("  NOCP : Accessed FPU when not present")
-    if usage_fault & 0x0004:
-        print("  INVPC : Invalid Program Counter(PC) load")
-    if usage_fault & 0x0002:
-        print("  INVSTATE : Invalid processor state")
-    if usage_fault & 0x0001:
-        print("  UNDEFINSTR : Undefined instruction")
-    return 4
-
-def decode_cfsr(cfsr, fault_addr):
-    error = 0
-    error = decode_cfsr_memory(cfsr, fault_addr) + error
-    error = decode_cfsr_bus(cfsr, fault_addr) + error
-    error = decode_cfsr_usage(cfsr) + error
-    return error
-
-
-def addr2line(addr):
-    cmd = ["arm-none-eabi-addr2line", "-e", ELF_FILE, "-f", "-C", hex(addr)]
-    try:
-        output = subprocess.check_output(cmd, text=True).strip()
-        return output
-    except Exception as e:
-        return f"addr2line failed: {e}"
-
-def analyze_call_stack(calltrace_depth, calltrace_pcs, context=2):
-    """
-    Muestra el call stack, omitiendo frames sin fuente y mostrando snippet de código.
-    """
-    print("\n==== Call Stack Trace ====")
-    if calltrace_depth == 0:
-        print("No call trace available.")
-        return
+def fault_address_valid(cfsr: int) -> bool:
+    return bool(cfsr & 0x80) or bool((cfsr >> 8) & 0x80)
 
-def analyze_call_stack(calltrace_depth, calltrace_pcs, context=0):
-    """
-    Muestra el call stack, mostrando snippet de código de la línea exacta
-    sin intentar sumar líneas arriba/abajo (context=0 por defecto).
-    Omite frames sin fuente.
-    """
-    print("\n==== Call Stack Trace ====")
-    if calltrace_depth == 0:
-        print("No call trace available.")
-        return
 
-    for pc in calltrace_pcs[:calltrace_depth]:
-        pc_base = pc & ~1
-        snippet = addr2line(pc_base- 4).strip()
-        if not snippet or snippet.startswith("??:?"):
-            continue  # no hay fuente, saltar
-        print_code_context(snippet,1)
+def decode_cfsr(cfsr: int) -> dict:
+    memory_fault = cfsr & 0xFF
+    bus_fault = (cfsr >> 8) & 0xFF
+    usage_fault = (cfsr >> 16) & 0xFFFF
+    return {
+        "memory": [name for bit, name, _ in MEMORY_FAULT_BITS if memory_fault & bit],
+        "bus": [name for bit, name, _ in BUS_FAULT_BITS if bus_fault & bit],
+        "usage": [name for bit, name, _ in USAGE_FAULT_BITS if usage_fault & bit],
+        "mmar_valid": bool(memory_fault & 0x80),
+        "bfar_valid": bool(bus_fault & 0x80),
+    }
 
-    print("======================================================")
 
+def build_report(records: list[dict], symbolizer: Symbolizer | None, core_clock_mhz: float) -> dict:
+    if symbolizer:
+        symbolizer.resolve_lines(a for record in records for a in record_addresses(record))
 
+    def location(address: int) -> dict:
+        if symbolizer:
+            return symbolizer.location(address)
+        return {"address": f"0x{address:08X}"}
 
+    faults = []
+    for record in records:
+        registers = record["registers"]
+        entry = {
+            "sequence": record["sequence"],
+            "slot": record["slot"],
+            "registers": {name: f"0x{value:08X}" for name, value in registers.items()},
+            "cfsr": f"0x{record['cfsr']:08X}",
+            "decoded": decode_cfsr(record["cfsr"]),
+            "pc": location(registers["pc"]),
+            "lr": location(registers["lr"] & ~1),
+            "call_trace": [location((pc & ~1) - 4) for pc in record["calltrace"]],
+        }
+        if fault_address_valid(record["cfsr"]):
+            entry["fault_address"] = location(record["fault_addr"])
+        if record["context"]:
+            context = dict(record["context"])
+            context["worst_tick_us"] = round(context["worst_tick_cycles"] / core_clock_mhz, 2)
+            context["last_tick_us"] = round(context["last_tick_cycles"] / core_clock_mhz, 2)
+            entry["context"] = context
+        faults.append(entry)
+    return {"elf": symbolizer.elf if symbolizer else None, "fault_count": len(faults), "faults": faults}
 
-def print_code_context(lines, context=2):
-    """
-    lines: exit of addr2line (función + file:line)
-    context: how many lines up/down show
-    """
-    line_list = lines.splitlines()
-    if len(line_list) < 2:
-        print("Invalid addr2line output")
-        return
 
-    file_line = line_list[1].strip()
-    split = file_line.rfind(':')
-    file_path = file_line[:split]
-    try:
-        line_no = int(file_line[split+1:]) - 1  # índice base 0
-    except ValueError:
+# --------------------------
+# Text output
+# --------------------------
+def print_code_context(location: dict, context: int = 2) -> None:
+    path, line = location.get("file"), location.get("line")
+    if not path or not line:
         print("\33[91m Couldn't find exact line\33[0m")
         return
-        if not os.path.exists(file_path):
-            print("Source file not found")
+    if not os.path.exists(path):
+        print(f"Source file not found: {path}")
         return
-
-    with open(file_path, "r") as f:
+    with open(path, "r") as f:
         file_lines = f.readlines()
-
+    line_no = line - 1
     start = max(0, line_no - context)
     end = min(len(file_lines), line_no + context + 1)
-
-    print(f"\nSource snippet from {file_path}:")
+    print(f"\nSource snippet from {path}:")
     for i in range(start, end):
         code = file_lines[i].rstrip()
-        # Si es la línea del error, la ponemos en rojo
         if i == line_no:
-            print(f"\033[91m{i+1:>4}: {code}\033[0m")  # rojo
+            print(f"\033[91m{i+1:>4}: {code}\033[0m")
         else:
             print(f"{i+1:>4}: {code}")
 
-def hard_fault_analysis(memory_string):
-    raw = bytes.fromhex(memory_string)
-    raw = struct.unpack(">28I",raw)
-    hf = {
-        "HF_Flag": raw[0],
-        "r0": raw[1],
-        "r1": raw[2],
-        "r2": raw[3],
-        "r3": raw[4],
-        "r12": raw[5],
-        "lr": raw[6],
-        "pc": raw[7],
-        "psr": raw[8],
-        "cfsr": raw[9],
-        "fault_addr": raw[10],
-        "calltrace_depth": raw[11],
-        "calltrace_pcs": raw[12:28]
-    }
-    if(hf["HF_Flag"] != 0xFF00FF00):
-        print("There was no hardfault in your Microcontroller, Kudos for you, I hope...")
-        return
-    print("================HARDFAULT DETECTED ===========")
+
+def describe(location: dict) -> str:
+    where = location.get("symbol") or location.get("function") or "??"
+    if location.get("file"):
+        where += f" ({location['file']}:{location['line']})"
+    return f"{location['address']} -> {where}"
+
+
+def print_fault(fault: dict, snippets: bool) -> None:
+    print(f"================ HARDFAULT #{fault['sequence']} (slot {fault['slot']}) ===========")
+    context = fault.get("context")
+    if context:
+        groups = ", ".join(context["enabled_groups"]) or "none"
+        print(f"  Uptime: {context['uptime_ms']} ms, state {context['state']}, tick {context['tick_count']}")
+        print(
+            f"  Control tick: last {context['last_tick_us']} us, worst {context['worst_tick_us']} us, "
+            f"groups running: {groups}"
+        )
     print("Registers:")
+    for name, value in fault["registers"].items():
+        print(f"  {name.upper():<4}: {value}")
+    print(f"  CFSR: {fault['cfsr']}")
+    decoded = fault["decoded"]
+    for kind, table in (("memory", MEMORY_FAULT_BITS), ("bus", BUS_FAULT_BITS), ("usage", USAGE_FAULT_BITS)):
+        for _, name, text in table:
+            if name in decoded[kind]:
+                print(f"  {name:<11}: {text}")
+    if "fault_address" in fault:
+        print(f"  Fault address   : {describe(fault['fault_address'])}")
+    print(f"  Linker Register : {describe(fault['lr'])}")
+    print(f"  Program Counter : {describe(fault['pc'])}")
+    if snippets:
+        print_code_context(fault["pc"])
+    print("\n==== Call Stack Trace ====")
+    if not fault["call_trace"]:
+        print("No call trace available.")
+    for frame in fault["call_trace"]:
+        if frame.get("file"):
+            print(f"  {describe(frame)}")
+    print()
 
-    for r in ['r0','r1','r2','r3','r12','lr','pc','psr']:
-        print(f"  {r.upper():<4}: 0x{hf[r]:08X}")
 
-    print(f"  CFSR: 0x{hf['cfsr']:08X}")
-    error = decode_cfsr(hf["cfsr"], hf["fault_addr"])
-    print("\nSource Location:")
-    pc_loc = addr2line(hf["pc"])
-    lr_loc = addr2line(hf["lr"])
-    print(f"  Linker Register : 0x{hf['lr']:08X} -> {lr_loc}")
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--elf", default=ELF_FILE, help="Firmware ELF used for symbols")
+    parser.add_argument("--file", type=Path, help="Decode a saved dump instead of reading SWD")
+    parser.add_argument("--json", type=Path, help="Write the machine-readable report here ('-' = stdout)")
+    parser.add_argument("--last", type=int, default=0, help="Only print the newest N faults")
+    parser.add_argument("--no-source", action="store_true", help="Don't print source snippets")
+    parser.add_argument("--core-clock-mhz", type=float, default=550.0, help="For cycle to us conversion")
+    args = parser.parse_args()
 
-    print(f"  Program Counter : 0x{hf['pc']:08X} -> {pc_loc}")
-    print_code_context(pc_loc)
+    try:
+        raw = args.file.read_bytes() if args.file else read_flash()
+    except (RuntimeError, OSError) as error:
+        print(error, file=sys.stderr)
+        return 1
 
-    analyze_call_stack(hf["calltrace_depth"],hf["calltrace_pcs"])
+    records = parse_slots(raw)
+    if not records:
+        print("There was no hardfault in your Microcontroller, Kudos for you, I hope...")
+        return 0
 
-    print("======================================================")
+    symbolizer = None
+    if os.path.exists(args.elf):
+        symbolizer = Symbolizer(args.elf)
+    else:
+        print(f"{args.elf} not found: addresses are not resolved", file=sys.stderr)
 
+    report = build_report(records, symbolizer, args.core_clock_mhz)
 
+    if args.json and str(args.json) == "-":
+        json.dump(report, sys.stdout, indent=2)
+        print()
+        return 0
+
+    faults = report["faults"][-args.last:] if args.last else report["faults"]
+    for fault in faults:
+        print_fault(fault, snippets=not args.no_source)
+    print(f"{report['fault_count']} faults in the log")
     print("Note: In Release builds (-O2/-O3) the PC may not point exactly to the failing instruction.")
     print("      During interrupts, bus faults, or stack corruption, the PC can be imprecise.")
-    print("\nIn case of Imprecise error is dificult to find due to is asynchronous fault")
-    print("The error has to be before PC. But not possible to know exactly when.")
     print("Check this link to know more : https://interrupt.memfault.com/blog/cortex-m-hardfault-debug#fn:8")
 
+    if args.json:
+        args.json.write_text(json.dumps(report, indent=2))
+    return 0
+
 
-if __name__ == '__main__':
-    out = read_flash()
-    if(out == None):
-        exit()
-    pos_memory_flash = out.rfind(HF_FLASH_ADDR_STRING)
-    print(out[0:pos_memory_flash])
-    flash = out[pos_memory_flash:]
-    print(flash)
-    memory_string = ""
-    for line in flash.splitlines():
-        if(line.find(':') == -1):
-            break
-        _,mem = line.split(":")
-        memory_string += mem
-    memory_string = memory_string.replace(" ","")
-    hard_fault_analysis(memory_string)
+if __name__ == "__main__":
+    sys.exit(main())
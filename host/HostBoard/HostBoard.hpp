@@ -0,0 +1,109 @@
+#ifndef HOST_BOARD_HPP
+#define HOST_BOARD_HPP
+
+#include "LCU_SLAVE_Types.hpp" // host/HostBoard
+#include "StateMachine/LCU_StateMachine.hpp"
+#include "Communications/Communications.hpp"
+
+// ============================================
+// Host instances (same shape as LCU_Slave::init())
+// ============================================
+// One mock per board device, wired the way Core/Inc/LCU_SLAVE.hpp wires the real
+// ones. Only the control tick is left out: host targets call
+// ControlExecutive::tick() themselves.
+
+namespace HostBoard {
+
+inline std::array<MockADC, Topology::VBAT_ADCS.size()> vbat_adcs;
+inline std::array<MockADC, Topology::SHUNT_ADCS.size()> shunt_adcs;
+inline std::array<MockADC, Topology::AIRGAP_ADCS.size()> airgap_adcs;
+inline std::array<MockPWM, Topology::PWM_COUNT> pwms;
+inline std::array<MockDigitalOutput, Topology::ENABLE_PINS.size()> enable_pins;
+inline MockDigitalOutput led_operational;
+inline MockDigitalOutput led_fault;
+inline MockDigitalOutput slave_fault;
+inline MockDigitalOutput slave_ready;
+inline MockSPI spi;
+
+template <size_t I> inline LCU_Slave::LPUType& lpu_instance() {
+    static auto lpu = LCU_Slave::LPUType(
+        pwms[2 * I],
+        pwms[2 * I + 1],
+        vbat_adcs[Topology::LPUS[I].vbat],
+        shunt_adcs[Topology::LPUS[I].shunt],
+        0.0f, 1.0f,
+        0.0f, 1.0f
+    );
+    return lpu;
+}
+
+template <size_t A> inline LCU_Slave::AirgapType& airgap_instance() {
+    static auto airgap = LCU_Slave::AirgapType(airgap_adcs[Topology::AIRGAPS[A].adc], 0.0f, 1.0f);
+    return airgap;
+}
+
+template <size_t... I, size_t... E>
+inline LCU_Slave::LpuArrayType&
+lpu_array_instance(std::index_sequence<I...>, std::index_sequence<E...>) {
+    static auto array =
+        LCU_Slave::LpuArrayType(std::tie(lpu_instance<I>()...), std::tie(enable_pins[E]...));
+    return array;
+}
+
+template <size_t... A>
+inline LCU_Slave::AirgapArrayType& airgap_array_instance(std::index_sequence<A...>) {
+    static auto array = LCU_Slave::AirgapArrayType(std::tie(airgap_instance<A>()...));
+    return array;
+}
+
+template <size_t... I, size_t... A>
+inline void init_frame(std::index_sequence<I...>, std::index_sequence<A...>) {
+    LCU_Slave::Frame::init(
+        Communications::comms,
+        lpu_instance<I>()...,
+        airgap_instance<A>()...,
+        Communications::comms,
+        lpu_instance<I>()...
+    );
+}
+
+/**
+ * @brief Wire the mocks and start the state machine, as LCU_Slave::init() does on the board.
+ */
+inline void init() {
+    using namespace LCU_Slave;
+
+    for (size_t c = 0; c < vbat_adcs.size(); c++) {
+        vbat_adcs[c].sample = &vbat_buffers[c];
+    }
+    for (size_t c = 0; c < shunt_adcs.size(); c++) {
+        shunt_adcs[c].sample = &shunt_buffers[c];
+    }
+    for (size_t c = 0; c < airgap_adcs.size(); c++) {
+        airgap_adcs[c].sample = &airgap_buffers[c];
+    }
+
+    g_led_operational = &led_operational;
+    g_led_fault = &led_fault;
+    g_slave_fault = &slave_fault;
+    Communications::g_spi = &spi;
+    Communications::g_slave_ready = &slave_ready;
+
+    g_lpu_array = &lpu_array_instance(
+        std::make_index_sequence<Topology::LPU_COUNT>{},
+        std::make_index_sequence<Topology::ENABLE_PINS.size()>{}
+    );
+    g_airgap_array = &airgap_array_instance(std::make_index_sequence<Topology::AIRGAP_COUNT>{});
+
+    Communications::init();
+    LCU_SM::start();
+    FmacFilter::start();
+    init_frame(
+        std::make_index_sequence<Topology::LPU_COUNT>{},
+        std::make_index_sequence<Topology::AIRGAP_COUNT>{}
+    );
+}
+
+} // namespace HostBoard
+
+#endif // HOST_BOARD_HPP
@@ -0,0 +1,201 @@
+#ifndef LCU_SLAVE_TYPES_HPP
+#define LCU_SLAVE_TYPES_HPP
+
+#include "ST-LIB.hpp"
+#include "LPU/LPU.hpp"
+#include "Airgap/Airgap.hpp"
+#include "Topology/Topology.hpp"
+#include "ConfigShared.hpp"
+#include "SpiShared.hpp"
+#include "FlagsShared.hpp"
+#include "Common/Placement.hpp"
+#include "Common/EventQueue.hpp"
+#include "Filters/FmacProgram.hpp"
+
+// ============================================
+// Host Board (host/ targets only)
+// ============================================
+// Stands in for Core/Inc/LCU_SLAVE_Types.hpp in the host builds (benchmarks,
+// replay): this directory comes first on the include path, so LPU, the state
+// machine and Communications compile unchanged against the mocks below. The
+// shapes (LPU, enable pin and airgap counts, channel sharing) come from the same
+// Topology tables as the firmware. HostBoard.hpp builds the instances.
+
+namespace HostBoard {
+
+// One ADC channel: points at its slot of the DMA buffers below, as the real one does
+struct MockADC {
+    const float* sample = nullptr;
+};
+
+// Same contract as LinearSensor: read() writes slope * raw + offset to *value
+template <typename T> class MockSensor {
+public:
+    MockSensor(MockADC& adc, float slope, float offset, T* value)
+        : adc(adc), slope(slope), offset(offset), value(value) {}
+
+    void read() { *value = slope * *adc.sample + offset; }
+
+    void set_offset(float new_offset) { offset = new_offset; }
+
+private:
+    MockADC& adc;
+    float slope;
+    float offset;
+    T* value;
+};
+
+// Register writes of a PWM channel land in a plain variable
+struct MockPWM {
+    volatile float duty = 0.0f;
+    volatile bool on = false;
+    uint32_t writes = 0; // Compare register writes, for the fuzz invariants
+
+    void set_duty_cycle(float duty_cycle) {
+        duty = duty_cycle;
+        writes++;
+    }
+    void turn_on() { on = true; }
+    void turn_off() { on = false; }
+};
+
+struct MockDigitalOutput {
+    volatile bool on = false;
+
+    void turn_on() { on = true; }
+    void turn_off() { on = false; }
+};
+
+// Completes every transfer as soon as it is started. When reply is set, the
+// transfer clocks it into the rx buffer (as the master would) and clears it.
+struct MockSPI {
+    bool aborted = false;
+    const uint8_t* reply = nullptr;
+
+    template <typename Tx, typename Rx> void transceive(Tx&, Rx& rx, volatile bool* done) {
+        if (reply != nullptr) {
+            std::memcpy(rx, reply, sizeof(rx));
+            reply = nullptr;
+        }
+        *done = true;
+    }
+    bool was_aborted() const { return aborted; }
+    void clear_abort_flag() { aborted = false; }
+    void set_software_nss(bool) {}
+};
+
+// Runs the FMAC program in software and completes every transfer as soon as it is
+// started. Accumulates at full precision, then truncates to q1.15 and clips as the
+// FMAC does; the FMAC's own accumulator is narrower, so its outputs can differ
+// from these in the last bit.
+struct MockFmac {
+    Fmac::Program program{};
+    std::array<int16_t, Fmac::FIR_MAX_P> x{}; // x[k] = x[n-k]
+    std::array<int16_t, Fmac::IIR_MAX_P> y{}; // y[k] = y[n-1-k]
+    uint32_t transfers = 0;
+
+    bool start(const Fmac::Program& loaded) {
+        program = loaded;
+        x.fill(0);
+        y.fill(0);
+        return true;
+    }
+
+    void transfer(const int16_t* input, int16_t* output, uint16_t count) {
+        for (uint16_t i = 0; i < count; i++) {
+            output[i] = step(input[i]);
+        }
+        transfers++;
+    }
+
+    bool busy() const { return false; }
+
+private:
+    int16_t step(int16_t sample) {
+        std::copy_backward(x.begin(), x.begin() + program.p - 1, x.begin() + program.p);
+        x[0] = sample;
+
+        int64_t accumulator = 0; // q2.30
+        for (size_t k = 0; k < program.p; k++) {
+            accumulator += int32_t{program.b[k]} * x[k];
+        }
+        for (size_t k = 0; k < program.q; k++) {
+            accumulator += int32_t{program.a[k]} * y[k];
+        }
+        int64_t value = (accumulator * (int64_t{1} << program.r)) >> 15;
+        auto out = static_cast<int16_t>(std::clamp<int64_t>(value, -32768, 32767));
+
+        if (program.q > 0) {
+            std::copy_backward(y.begin(), y.begin() + program.q - 1, y.begin() + program.q);
+            y[0] = out;
+        }
+        return out;
+    }
+};
+
+} // namespace HostBoard
+
+namespace LCU_Slave {
+
+#ifdef USE_SPI_ERROR
+constexpr uint32_t MAX_SPI_ERRORS = 10;
+constexpr uint32_t SPI_TIMEOUT_LIMIT = 1000;
+#endif
+
+bool master_fault_triggered = false;
+
+inline uint32_t reset_counter = 0;
+inline constexpr uint32_t MASTER_FAULT_RESET_COUNT = 5;
+
+// Posted by the host targets where the EXTI callback would
+enum class MasterFaultEvent : uint8_t { FALLING_EDGE };
+inline EventQueue<MasterFaultEvent, 8> master_fault_events;
+
+// Nothing to reset on the host: requests are counted, the harness reboots the board
+inline uint32_t system_resets = 0;
+inline void system_reset() { system_resets++; }
+
+// What the ADC DMA streams would write; the replay harness fills them from a capture
+inline std::array<float, Topology::VBAT_ADCS.size()> vbat_buffers{};
+inline std::array<float, Topology::SHUNT_ADCS.size()> shunt_buffers{};
+inline std::array<float, Topology::AIRGAP_ADCS.size()> airgap_buffers{};
+
+using DigitalOutputType = HostBoard::MockDigitalOutput;
+using EnablePinType = DigitalOutputType;
+
+using LPUType = LPU<HostBoard::MockPWM, HostBoard::MockPWM, HostBoard::MockSensor<volatile float>>;
+using AirgapType = BasicAirgap<HostBoard::MockSensor<volatile float>>;
+
+template <typename T, size_t> using Repeat = T;
+
+template <size_t... I, size_t... E>
+auto lpu_array_for(std::index_sequence<I...>, std::index_sequence<E...>)
+    -> LpuArray<std::tuple<Repeat<LPUType, I>...>, std::tuple<Repeat<EnablePinType, E>...>>;
+
+template <size_t... A>
+auto airgap_array_for(std::index_sequence<A...>)
+    -> AirgapArray<std::tuple<Repeat<AirgapType, A>...>>;
+
+using LpuArrayType = decltype(lpu_array_for(
+    std::make_index_sequence<Topology::LPU_COUNT>{},
+    std::make_index_sequence<Topology::ENABLE_PINS.size()>{}
+));
+
+using AirgapArrayType =
+    decltype(airgap_array_for(std::make_index_sequence<Topology::AIRGAP_COUNT>{}));
+
+using Frame = SystemFrame<false>; // false for Slave
+
+using SpiType = HostBoard::MockSPI;
+
+using FmacDeviceType = HostBoard::MockFmac;
+
+LpuArrayType* g_lpu_array;
+AirgapArrayType* g_airgap_array;
+DigitalOutputType* g_led_operational;
+DigitalOutputType* g_led_fault;
+DigitalOutputType* g_slave_fault;
+
+} // namespace LCU_Slave
+
+#endif // LCU_SLAVE_TYPES_HPP
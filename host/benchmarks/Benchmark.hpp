@@ -0,0 +1,142 @@
+#ifndef BENCHMARK_HPP
+#define BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// ============================================
+// Host micro-benchmark harness
+// ============================================
+// Each benchmark body is run in a calibrated loop; the reported figures are the
+// median over several repetitions of wall time and retired user-space
+// instructions per call. Instruction counts come from perf_event_open and are
+// what the regression gate compares by default: unlike time, they do not move
+// with CPU frequency or a noisy neighbour. Where perf events are not allowed
+// (containers, kernel.perf_event_paranoid > 2) they are reported as unavailable.
+
+namespace Benchmark {
+
+struct Result {
+    std::string name;
+    double ns_per_op;
+    double instructions_per_op; // NaN when perf events are unavailable
+    uint64_t iterations;        // Per repetition
+};
+
+class InstructionCounter {
+public:
+    InstructionCounter() {
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~InstructionCounter() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    InstructionCounter(const InstructionCounter&) = delete;
+    InstructionCounter& operator=(const InstructionCounter&) = delete;
+
+    bool available() const { return fd >= 0; }
+
+    void start() {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    uint64_t stop() {
+        uint64_t count = 0;
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+        return count;
+    }
+
+private:
+    int fd = -1;
+};
+
+// Keeps the compiler from assuming anything about memory across the call
+inline void clobber() { asm volatile("" ::: "memory"); }
+
+struct Options {
+    unsigned repetitions = 9;
+    std::chrono::nanoseconds min_time = std::chrono::milliseconds(20); // Per repetition
+};
+
+template <typename Body> double time_loop(Body& body, uint64_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; i++) {
+        body();
+        clobber();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count();
+}
+
+inline double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    return values[values.size() / 2];
+}
+
+/**
+ * @brief Measure body(). It is called many times in a row, so it must leave the system
+ * in a state where calling it again measures the same path.
+ */
+template <typename Body>
+Result run(
+    const std::string& name,
+    Body&& body,
+    InstructionCounter& counter,
+    const Options& options
+) {
+    uint64_t iterations = 1;
+    while (time_loop(body, iterations) < static_cast<double>(options.min_time.count()) &&
+           iterations < (uint64_t{1} << 32)) {
+        iterations *= 2;
+    }
+
+    std::vector<double> ns;
+    std::vector<double> instructions;
+    for (unsigned r = 0; r < options.repetitions; r++) {
+        counter.start();
+        double elapsed = time_loop(body, iterations);
+        uint64_t retired = counter.stop();
+        ns.push_back(elapsed / static_cast<double>(iterations));
+        instructions.push_back(static_cast<double>(retired) / static_cast<double>(iterations));
+    }
+
+    return Result{
+        name,
+        median(ns),
+        counter.available() ? median(instructions) : std::nan(""),
+        iterations
+    };
+}
+
+} // namespace Benchmark
+
+#endif // BENCHMARK_HPP
@@ -0,0 +1,221 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string_view>
+
+#include "Benchmark.hpp"
+#include "HostBoard.hpp"
+
+// Host benchmarks of the control hot paths, built by the simulator presets:
+//   cmake --preset simulator && cmake --build --preset simulator --target lcu_benchmarks
+//   out/build/simulator/host/lcu_benchmarks [--json results.json] [--filter lpu]
+// tools/benchmark_gate.py compares a run against host/benchmarks/baseline-<N>dof.json.
+
+namespace {
+
+using namespace LCU_Slave;
+
+// Fixed sensor readings, then a first sample as the SENSORS rate group takes from boot
+void init_host_board() {
+    HostBoard::init();
+
+    vbat_buffers.fill(48.0f);
+    for (size_t i = 0; i < shunt_buffers.size(); i++) {
+        shunt_buffers[i] = 1.0f + 0.25f * static_cast<float>(i);
+    }
+    for (size_t i = 0; i < airgap_buffers.size(); i++) {
+        airgap_buffers[i] = 0.018f + 0.001f * static_cast<float>(i);
+    }
+
+#ifdef USE_SPI_ERROR
+    Communications::spi_error_counter = 0; // A synced link, so the SM can leave SPI_CONNECTING
+#endif
+    g_lpu_array->update_all();
+    g_airgap_array->update();
+}
+
+// Run the state machine until it settles with the given command flags
+bool settle(CommandFlags flags, LCU_SM::OperationalState expected) {
+    Communications::comms.command_packet.flags = flags;
+    for (int i = 0; i < 4 && LCU_SM::sm_operational.get_current_state() != expected; i++) {
+        LCU_SM::update();
+    }
+    return LCU_SM::sm_operational.get_current_state() == expected;
+}
+
+// ============================================
+// Output
+// ============================================
+
+void print_table(const std::vector<Benchmark::Result>& results, bool instructions) {
+    std::printf("%-34s %12s %14s %12s\n", "benchmark", "ns/op", "instr/op", "iterations");
+    for (const auto& result : results) {
+        if (instructions) {
+            std::printf(
+                "%-34s %12.2f %14.1f %12llu\n",
+                result.name.c_str(),
+                result.ns_per_op,
+                result.instructions_per_op,
+                static_cast<unsigned long long>(result.iterations)
+            );
+        } else {
+            std::printf(
+                "%-34s %12.2f %14s %12llu\n",
+                result.name.c_str(),
+                result.ns_per_op,
+                "n/a",
+                static_cast<unsigned long long>(result.iterations)
+            );
+        }
+    }
+    if (!instructions) {
+        std::printf("Instruction counts unavailable (perf_event_open denied)\n");
+    }
+}
+
+bool write_json(const char* path, const std::vector<Benchmark::Result>& results) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out) {
+        return false;
+    }
+    out << "{\n  \"version\": 1,\n  \"dof\": " << Topology::DOF << ",\n  \"benchmarks\": {\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const auto& result = results[i];
+        out << "    \"" << result.name << "\": {\"ns_per_op\": " << result.ns_per_op
+            << ", \"instructions_per_op\": ";
+        if (std::isnan(result.instructions_per_op)) {
+            out << "null";
+        } else {
+            out << result.instructions_per_op;
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  }\n}\n";
+    return bool(out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const char* json_path = nullptr;
+    std::string_view filter;
+    Benchmark::Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--json" && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (arg == "--filter" && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (arg == "--repetitions" && i + 1 < argc) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::fprintf(
+                stderr,
+                "Usage: %s [--json <file>] [--filter <substring>] [--repetitions <n>]\n",
+                argv[0]
+            );
+            return 1;
+        }
+    }
+
+    init_host_board();
+
+    Benchmark::InstructionCounter counter;
+    std::vector<Benchmark::Result> results;
+    auto bench = [&](const std::string& name, auto&& body) {
+        if (filter.empty() || name.find(filter) != std::string::npos) {
+            results.push_back(Benchmark::run(name, body, counter, options));
+        }
+    };
+
+    auto& lpu = g_lpu_array->get_lpu<0>();
+
+    // Sensing (SENSORS rate group)
+    bench("lpu_update", [&] { lpu.update(); });
+    bench("lpu_array_update_all", [&] { g_lpu_array->update_all(); });
+    bench("airgap_array_update", [&] { g_airgap_array->update(); });
+
+    // CPU side of the FMAC sensor filters: every channel to q1.15 and back (the
+    // filtering itself runs on the FMAC, modelled by MockFmac here)
+    bench("fmac_convert", [] {
+        FmacFilter::gather();
+        FmacFilter::scatter(FmacFilter::input_q15);
+    });
+
+    // CPU sensor filters: each bank type over every channel, then the whole
+    // gather-filter-scatter pass as this build compiles it (USE_SENSOR_FILTERS)
+    static FilterBank<moving_average(10), SensorChannels::COUNT> average_bank;
+    static FilterBank<exponential(0.25f), SensorChannels::COUNT> exponential_bank;
+    // 2nd-order Butterworth low-pass, 1 kHz at the 10 kHz SENSORS rate
+    static FilterBank<biquad(0.067455f, 0.134911f, 0.067455f, -1.142981f, 0.412802f),
+                      SensorChannels::COUNT>
+        biquad_bank;
+    std::array<float, SensorChannels::COUNT> samples{};
+    bench("filter_bank_average10", [&] { average_bank.update(samples); });
+    bench("filter_bank_exponential", [&] { exponential_bank.update(samples); });
+    bench("filter_bank_biquad", [&] { biquad_bank.update(samples); });
+    bench("sensor_filters_update", [] { SensorFilters::update(); });
+
+    // Actuation (CURRENT rate group): sweep both signs so both PWM branches are taken
+    std::array<float, 16> voltages{};
+    for (size_t i = 0; i < voltages.size(); i++) {
+        voltages[i] = -40.0f + 5.0f * static_cast<float>(i);
+    }
+    size_t next_voltage = 0;
+    bench("lpu_set_out_voltage", [&] {
+        lpu.set_out_voltage(voltages[next_voltage]);
+        next_voltage = (next_voltage + 1) % voltages.size();
+    });
+
+    // Current loop (CURRENT rate group): the generated step against the native PI
+    // (Control/Pid.hpp), one LPU each, then the loop as this build compiles it
+    control_U.corriente_real = lpu.shunt_v;
+    bench("control_step0", [] { control_step0(); });
+    Control::CurrentPi current_pi;
+    float voltage = 0.0f;
+    bench("current_pi_step", [&] {
+        voltage = current_pi.step(Control::current_gains, 0.0f, lpu.shunt_v);
+    });
+    bench("control_current_update", [] { Control::current_update(); });
+
+    // Outer loop (LEVITATION rate group): MimoLevitation in 5-DOF, control_step1 in 1-DOF
+    bench("control_levitation_update", [] { Control::levitation_update(0.020f); });
+
+    // Gain schedule lookup (LEVITATION rate group), on a table the size the generator writes
+    static constexpr auto gain_table = make_gain_table<33, 3>(0.010f, 0.030f, [](float gap) {
+        return std::array<float, 3>{1e5f * gap, 1e6f * gap, 2e3f * gap};
+    });
+    std::array<float, 3> gains{};
+    bench("gain_table_lookup", [&] {
+        gains = gain_table.at(g_airgap_array->get_airgap<0>().airgap_v);
+    });
+
+    // State machine transitions check (background loop), in its two steady states
+    if (!settle(CommandFlags{}, LCU_SM::OperationalState::IDLE)) {
+        std::fprintf(stderr, "State machine did not reach IDLE\n");
+        return 1;
+    }
+    bench("sm_check_transitions_idle", [] { LCU_SM::sm_operational.check_transitions(); });
+
+    if constexpr (Control::CAN_LEVITATE) {
+        if (!settle(CommandFlags::LEVITATE, LCU_SM::OperationalState::LEVITATING)) {
+            std::fprintf(stderr, "State machine did not reach LEVITATING\n");
+            return 1;
+        }
+        bench("sm_check_transitions_levitating", [] {
+            LCU_SM::sm_operational.check_transitions();
+        });
+    } else {
+        std::printf("sm_check_transitions_levitating skipped: this build cannot levitate\n");
+    }
+
+    // SPI frame exchange: four calls per frame (tx, transfer, rx, validate), averaged
+    bench("communications_update", [] { Communications::update(); });
+
+    print_table(results, counter.available());
+    if (json_path != nullptr && !write_json(json_path, results)) {
+        std::fprintf(stderr, "Cannot write %s\n", json_path);
+        return 1;
+    }
+    return 0;
+}
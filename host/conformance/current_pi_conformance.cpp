@@ -0,0 +1,186 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numbers>
+#include <string_view>
+
+#include "HostBoard.hpp"
+#include "ReplayStream.hpp"
+
+// Checks that the native current PI (Control/Pid.hpp with the gains identified from
+// the model, Control::model_current_gains()) computes what the generated
+// control_step0() computes, step for step, on the same measured currents. The
+// identification only fixes kp, ki and the limits; saturation, anti-windup and
+// rounding are what this compares. Registered with ctest (label conformance):
+//   ctest --preset simulator-conformance
+//   out/build/simulator/host/current_pi_conformance [capture.lcur] [--tolerance <relative>]
+// Without a capture it runs a synthetic sweep that drives the loop in and out of
+// saturation; with one it takes the shunt current of the first LPU from every ADC record.
+// Both engines see a zero reference, which is what the model uses in CURRENT_CONTROL.
+// Exit code 0 when every output matches, 1 otherwise, 77 in builds without a generated loop.
+
+namespace {
+
+using ReplayCapture::AdcPayload;
+using ReplayCapture::Record;
+using ReplayCapture::RecordType;
+using ReplayStream::payload_of;
+using ReplayStream::type_of;
+
+constexpr int SKIPPED = 77;
+
+// Ticks of the synthetic sweep: 2 s of the CURRENT group
+constexpr size_t SYNTHETIC_STEPS = 10'000;
+
+struct Options {
+    const char* capture = nullptr;
+    float tolerance = 1e-4f; // Relative, with an absolute floor of the same size
+    size_t max_reported = 10;
+};
+
+struct Comparison {
+    const Options& options;
+    PidGains gains{};
+    Control::CurrentPi native{};
+    size_t steps = 0;
+    size_t saturated = 0;
+    size_t mismatches = 0;
+    double max_error = 0.0;
+    double squared_error = 0.0;
+
+    void reset() {
+        gains = Control::model_current_gains();
+        Control::init();
+        native.reset();
+    }
+
+    void step(float current) {
+        control_U.corriente_real = current;
+        control_step0();
+        float generated = control_Y.Voltage;
+        float ours = native.step(gains, 0.0f, current);
+
+        double error = std::fabs(static_cast<double>(generated) - ours);
+        max_error = std::max(max_error, error);
+        squared_error += error * error;
+        if (ours <= gains.output_min || ours >= gains.output_max) {
+            saturated++;
+        }
+        if (error > options.tolerance * std::max(1.0f, std::fabs(generated))) {
+            if (mismatches < options.max_reported) {
+                std::printf(
+                    "Mismatch at step %zu: current %g A, generated %g V, native %g V\n",
+                    steps,
+                    current,
+                    generated,
+                    ours
+                );
+            }
+            mismatches++;
+        }
+        steps++;
+    }
+
+    int report() const {
+        std::printf(
+            "%zu steps compared (%zu saturated), %zu mismatches, max error %.3g V, "
+            "RMS error %.3g V\n",
+            steps,
+            saturated,
+            mismatches,
+            max_error,
+            steps > 0 ? std::sqrt(squared_error / steps) : 0.0
+        );
+        return mismatches == 0 ? 0 : 1;
+    }
+};
+
+// Small signals around zero, steps large enough to saturate either way and a slow
+// ramp through both limits, so the anti-windup paths are exercised
+float synthetic_current(size_t step) {
+    float t = step * Control::CurrentPi::SAMPLE_TIME_S;
+    float current = 0.3f * std::sin(2.0f * std::numbers::pi_v<float> * 50.0f * t);
+    switch (step * 4 / SYNTHETIC_STEPS) {
+    case 0:
+        break;
+    case 1:
+        current += (step / 500) % 2 ? 8.0f : -8.0f;
+        break;
+    case 2:
+        current += 12.0f * std::sin(2.0f * std::numbers::pi_v<float> * 2.0f * t);
+        break;
+    default:
+        current += (step % 1000) * 0.01f - 5.0f;
+        break;
+    }
+    return current;
+}
+
+int run_synthetic(Comparison& comparison) {
+    comparison.reset();
+    for (size_t step = 0; step < SYNTHETIC_STEPS; step++) {
+        comparison.step(synthetic_current(step));
+    }
+    return comparison.report();
+}
+
+// The shunt reading goes through the LPU conversion, as in the SENSORS group
+int run_capture(Comparison& comparison, const char* path) {
+    std::vector<Record> records;
+    std::string error;
+    if (!ReplayStream::read(path, records, error)) {
+        std::fprintf(stderr, "%s: %s\n", path, error.c_str());
+        return 1;
+    }
+
+    HostBoard::init();
+    comparison.reset();
+    for (const auto& record : records) {
+        if (type_of(record) != RecordType::ADC) {
+            continue;
+        }
+        auto payload = payload_of<AdcPayload>(record);
+        std::ranges::copy(payload.shunt, LCU_Slave::shunt_buffers.begin());
+        LCU_Slave::g_lpu_array->update_all();
+        comparison.step(LCU_Slave::g_lpu_array->get_lpu<0>().shunt_v);
+    }
+    return comparison.report();
+}
+
+bool parse(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--tolerance" && i + 1 < argc) {
+            options.tolerance = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--max-reported" && i + 1 < argc) {
+            options.max_reported = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!arg.starts_with("--") && options.capture == nullptr) {
+            options.capture = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(
+            stderr,
+            "Usage: %s [capture.lcur] [--tolerance <relative>] [--max-reported <n>]\n",
+            argv[0]
+        );
+        return 1;
+    }
+    if constexpr (!Control::HAS_CONTROLLER) {
+        std::printf("No generated current loop in this build, nothing to compare\n");
+        return SKIPPED;
+    }
+
+    Comparison comparison{options};
+    return options.capture == nullptr ? run_synthetic(comparison)
+                                      : run_capture(comparison, options.capture);
+}
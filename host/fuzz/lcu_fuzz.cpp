@@ -0,0 +1,464 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include "HostBoard.hpp"
+#include "StateMachine/MasterFaultEvents.hpp"
+
+// libFuzzer-style target for everything the master can make the slave do: SPI
+// frames through Communications (Frame::update_rx and its validation), then
+// LCU_SM and the control rate groups, in any interleaving with control ticks,
+// SPI aborts and master fault edges. After every step it checks:
+//   - FAULT: no PWM channel on, no LPU enabled
+//   - every LPU duty finite and within +-100 %, every PWM duty within 0..100 %
+//   - an LPU is only enabled or driven through its own bit of the masks
+// A violation aborts, so libFuzzer (or the standalone driver) keeps the input.
+//
+// Built with Clang it links libFuzzer (-fsanitize=fuzzer,address,undefined):
+//   out/build/simulator/host/lcu_fuzz -max_total_time=600 corpus/
+// Built with GCC it has its own random driver, which also reports the throughput
+// of the frame path:
+//   out/build/simulator/host/lcu_fuzz --runs 100000 [--seed 1] [crash-file|corpus-dir...]
+
+namespace {
+
+using namespace LCU_Slave;
+
+constexpr size_t FRAME_SIZE = sizeof(Frame::rx_buffer);
+constexpr size_t ADC_COUNT = vbat_buffers.size() + shunt_buffers.size() + airgap_buffers.size();
+
+// Background iterations allowed to get one frame through the SPI exchange
+constexpr int MAX_FRAME_STEPS = 8;
+
+// Input: a sequence of operations, each an op byte and its operands
+enum class Op : uint8_t {
+    FRAME,        // FRAME_SIZE bytes clocked in by the master, then decoded
+    TICK,         // One int16 per ADC channel (x 0.002 V), then a control tick
+    BACKGROUND,   // 1 byte: 1..8 background iterations, the master repeating its frame
+    SPI_ABORT,    // The transfer in flight aborts
+    MASTER_FAULT, // A master fault edge, posted to master_fault_events
+    COUNT
+};
+
+class Input {
+public:
+    Input(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    bool empty() const { return offset >= size; }
+
+    uint8_t byte() { return offset < size ? data[offset++] : 0; }
+
+    // Past the end, the missing bytes read as zero
+    void bytes(uint8_t* out, size_t count) {
+        size_t available = std::min(count, size - std::min(offset, size));
+        std::memcpy(out, data + offset, available);
+        std::memset(out + available, 0, count - available);
+        offset += available;
+    }
+
+    int16_t int16() {
+        uint8_t low = byte();
+        return static_cast<int16_t>(low | (byte() << 8));
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t offset = 0;
+};
+
+struct Stats {
+    uint64_t inputs = 0;
+    uint64_t ops = 0;
+    uint64_t frames = 0;
+    uint64_t input_ops = 0; // Of the input running, for the violation report
+};
+
+Stats stats;
+const uint8_t* current_data = nullptr;
+size_t current_size = 0;
+
+// ============================================
+// Board state
+// ============================================
+
+auto& pristine_state_machine() {
+    static const auto sm = LCU_SM::sm_operational;
+    return sm;
+}
+
+// Back to the state LCU_Slave::init() leaves, so every input starts from boot
+void reset_board() {
+    using ControlExecutive::RateGroup;
+
+    static bool initialized = false;
+    if (!initialized) {
+        HostBoard::init();
+        pristine_state_machine();
+        initialized = true;
+    }
+
+    for (auto group : {RateGroup::SENSORS, RateGroup::CURRENT, RateGroup::LEVITATION}) {
+        ControlExecutive::disable(group);
+    }
+    ControlExecutive::tick_count = 0;
+
+    LCU_SM::sm_operational = pristine_state_machine();
+    LCU_SM::recorded_state = LCU_SM::OperationalState::SPI_CONNECTING;
+    LCU_SM::power_stage_live = false;
+    LCU_SM::lpu_buffer_forced = false;
+    master_fault_triggered = false;
+    master_fault_events.drain([](const auto&) {});
+    master_fault_dropped_seen = master_fault_events.dropped();
+    reset_counter = 0;
+    system_resets = 0;
+
+    Communications::comms.command_packet = CommandPacket{};
+    Communications::operation_flag = false;
+    Communications::send_flag = false;
+    Communications::spi_flag = false;
+    Communications::receive_flag = false;
+#ifdef USE_SPI_ERROR
+    Communications::spi_error_counter = MAX_SPI_ERRORS;
+#ifdef USE_SPI_TIMEOUT
+    Communications::spi_timeout_counter = 0;
+#endif
+#endif
+    std::memset(Frame::rx_buffer, 0, sizeof(Frame::rx_buffer));
+
+    g_lpu_array->disable_all();
+    g_lpu_array->for_each([](auto& lpu) {
+        lpu.duty_cycle = 0.0f;
+        lpu.is_fixed_duty_cycle = false;
+        lpu.fixed_duty_cycle = 0.0f;
+        lpu.is_fixed_vbat = false;
+        lpu.fixed_vbat = 0.0f;
+    });
+    HostBoard::pwms.fill(HostBoard::MockPWM{});
+    HostBoard::spi = HostBoard::MockSPI{};
+    vbat_buffers.fill(48.0f);
+    shunt_buffers.fill(0.0f);
+    airgap_buffers.fill(0.0f);
+
+    Control::deinit();
+    LCU_SM::start();
+}
+
+// ============================================
+// Invariants
+// ============================================
+
+[[noreturn]] void fail(const char* invariant, size_t lpu) {
+    auto state = static_cast<unsigned>(LCU_SM::sm_operational.get_current_state());
+    std::fprintf(
+        stderr,
+        "Invariant violated: %s (LPU %zu, state %u, tick %u, op %llu of the input)\n",
+        invariant,
+        lpu,
+        state,
+        static_cast<unsigned>(ControlExecutive::tick_count),
+        static_cast<unsigned long long>(stats.input_ops)
+    );
+#ifndef LCU_FUZZ_LIBFUZZER
+    // libFuzzer keeps the input itself
+    std::ofstream crash("lcu_fuzz-crash.bin", std::ios::binary);
+    crash.write(
+        reinterpret_cast<const char*>(current_data),
+        static_cast<std::streamsize>(current_size)
+    );
+    crash.close();
+    std::fprintf(stderr, "Input written to lcu_fuzz-crash.bin\n");
+#endif
+    std::abort();
+}
+
+// The bits of the ENABLE_LPU_BUFFER mask that enable LPU i (its pair)
+constexpr uint32_t pair_bits(size_t i) { return 0x3U << (2 * (i / 2)); }
+
+void check_invariants() {
+    bool in_fault = LCU_SM::sm_operational.get_current_state() == LCU_SM::OperationalState::FAULT;
+
+    for (size_t k = 0; k < HostBoard::pwms.size(); k++) {
+        const auto& pwm = HostBoard::pwms[k];
+        if (in_fault && pwm.on) {
+            fail("PWM on in FAULT", k / 2);
+        }
+        float duty = pwm.duty;
+        if (!std::isfinite(duty) || duty < 0.0f || duty > 100.0f) {
+            fail("PWM duty outside 0..100 %", k / 2);
+        }
+    }
+
+    uint32_t buffer_mask = LCU_SM::lpu_buffer_forced
+        ? Communications::comms.command_packet.force_enable_lpu_buffer.lpu_buffer_id_bitmask
+        : 0;
+    g_lpu_array->for_each_indexed([&](auto& lpu, size_t i) {
+        if (in_fault && lpu.is_enabled) {
+            fail("LPU enabled in FAULT", i);
+        }
+        if (!std::isfinite(lpu.duty_cycle) || std::fabs(lpu.duty_cycle) > 100.0f) {
+            fail("LPU duty outside +-100 %", i);
+        }
+        // Outside the control states only ENABLE_LPU_BUFFER enables LPUs
+        if (!LCU_SM::power_stage_live && lpu.is_enabled && !(buffer_mask & pair_bits(i))) {
+            fail("LPU enabled without its bit in the buffer mask", i);
+        }
+    });
+}
+
+// ============================================
+// Operations
+// ============================================
+
+// Same order as LCU_Slave::update(). A reset request reboots the board.
+void background_step() {
+    handle_events();
+    if (system_resets != 0) {
+        reset_board();
+        return;
+    }
+    Communications::update();
+    LCU_SM::update();
+}
+
+void run_frame(Input& input) {
+    std::array<uint8_t, FRAME_SIZE> frame;
+    input.bytes(frame.data(), frame.size());
+    HostBoard::spi.reply = frame.data();
+    for (int step = 0; step < MAX_FRAME_STEPS; step++) {
+        background_step();
+        if (HostBoard::spi.reply == nullptr && !Communications::spi_flag) {
+            break;
+        }
+    }
+    HostBoard::spi.reply = nullptr;
+    stats.frames++;
+}
+
+// The current loop may only write the PWMs of LPUs selected by its bitmask
+void run_tick(Input& input) {
+    for (auto& value : vbat_buffers) {
+        value = 0.002f * input.int16();
+    }
+    for (auto& value : shunt_buffers) {
+        value = 0.002f * input.int16();
+    }
+    for (auto& value : airgap_buffers) {
+        value = 0.002f * input.int16();
+    }
+
+    std::array<uint32_t, Topology::PWM_COUNT> writes;
+    for (size_t k = 0; k < writes.size(); k++) {
+        writes[k] = HostBoard::pwms[k].writes;
+    }
+    uint16_t current_mask = Communications::comms.command_packet.current_control.lpu_id_bitmask;
+
+    ControlExecutive::tick();
+
+    g_lpu_array->for_each_indexed([&](auto& lpu, size_t i) {
+        bool selected = i < 16 && (current_mask & (1U << i));
+        bool written = HostBoard::pwms[2 * i].writes != writes[2 * i] ||
+                       HostBoard::pwms[2 * i + 1].writes != writes[2 * i + 1];
+        if (written && !selected && !lpu.is_fixed_duty_cycle) {
+            fail("Current loop drove an LPU outside its bitmask", i);
+        }
+    });
+}
+
+void run(Input& input) {
+    switch (static_cast<Op>(input.byte() % static_cast<uint8_t>(Op::COUNT))) {
+    case Op::FRAME:
+        run_frame(input);
+        break;
+    case Op::TICK:
+        run_tick(input);
+        break;
+    case Op::BACKGROUND:
+        for (int i = 0, steps = input.byte() % 8 + 1; i < steps; i++) {
+            background_step();
+        }
+        break;
+    case Op::SPI_ABORT:
+        HostBoard::spi.aborted = true;
+        background_step();
+        break;
+    case Op::MASTER_FAULT:
+        master_fault_events.post(MasterFaultEvent::FALLING_EDGE);
+        background_step();
+        break;
+    case Op::COUNT:
+        break;
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    current_data = data;
+    current_size = size;
+    reset_board();
+    stats.inputs++;
+    stats.input_ops = 0;
+
+    Input input(data, size);
+    while (!input.empty()) {
+        run(input);
+        stats.ops++;
+        stats.input_ops++;
+        check_invariants();
+    }
+    return 0;
+}
+
+#ifndef LCU_FUZZ_LIBFUZZER
+
+// ============================================
+// Standalone driver (no libFuzzer)
+// ============================================
+
+namespace {
+
+// Random operations, with frames that mostly pass the start byte check so the
+// decoder and the state machine get exercised, not just the error counter
+std::vector<uint8_t> random_input(std::mt19937& rng, size_t max_ops) {
+    std::vector<uint8_t> data;
+    auto random_byte = [&] { return static_cast<uint8_t>(rng()); };
+    size_t ops = rng() % max_ops + 1;
+    for (size_t n = 0; n < ops; n++) {
+        auto op = static_cast<Op>(rng() % static_cast<uint32_t>(Op::COUNT));
+        data.push_back(static_cast<uint8_t>(op));
+        switch (op) {
+        case Op::FRAME: {
+            size_t start = data.size();
+            for (size_t i = 0; i < FRAME_SIZE; i++) {
+                data.push_back(random_byte());
+            }
+            if (rng() % 4 != 0) {
+                uint16_t start_byte = CommandPacket::START_BYTE;
+                std::memcpy(data.data() + start, &start_byte, sizeof(start_byte));
+            }
+            break;
+        }
+        case Op::TICK:
+            for (size_t i = 0; i < 2 * ADC_COUNT; i++) {
+                data.push_back(random_byte());
+            }
+            break;
+        case Op::BACKGROUND:
+            data.push_back(random_byte());
+            break;
+        default:
+            break;
+        }
+    }
+    return data;
+}
+
+void run_file(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<uint8_t> data(
+        (std::istreambuf_iterator<char>(in)),
+        std::istreambuf_iterator<char>()
+    );
+    LLVMFuzzerTestOneInput(data.data(), data.size());
+}
+
+// Frames only, back to back: the rate the slave can take frames at on this host
+void report_frame_throughput(std::mt19937& rng) {
+    constexpr size_t FRAMES = 200'000;
+    std::vector<uint8_t> data;
+    data.reserve(FRAMES * (FRAME_SIZE + 1));
+    for (size_t n = 0; n < FRAMES; n++) {
+        data.push_back(static_cast<uint8_t>(Op::FRAME));
+        uint16_t start_byte = CommandPacket::START_BYTE;
+        size_t start = data.size();
+        for (size_t i = 0; i < FRAME_SIZE; i++) {
+            data.push_back(static_cast<uint8_t>(rng()));
+        }
+        std::memcpy(data.data() + start, &start_byte, sizeof(start_byte));
+    }
+
+    reset_board();
+    Input input(data.data(), data.size());
+    auto start = std::chrono::steady_clock::now();
+    while (!input.empty()) {
+        run(input);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = std::chrono::duration<double>(elapsed).count();
+
+    std::printf(
+        "Frame path: %.0f frames/s, %.1f MB/s of frame data (%.0f ns per frame)\n",
+        FRAMES / seconds,
+        FRAMES * FRAME_SIZE / seconds / 1e6,
+        seconds / FRAMES * 1e9
+    );
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    uint64_t runs = 0;
+    uint32_t seed = 1;
+    size_t max_ops = 64;
+    std::vector<std::filesystem::path> files;
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--runs" && i + 1 < argc) {
+            runs = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--max-ops" && i + 1 < argc) {
+            max_ops = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (!arg.starts_with("--")) {
+            files.emplace_back(argv[i]);
+        } else {
+            std::fprintf(
+                stderr,
+                "Usage: %s [--runs <n>] [--seed <n>] [--max-ops <n>] [file|directory...]\n",
+                argv[0]
+            );
+            return 1;
+        }
+    }
+    if (files.empty() && runs == 0) {
+        runs = 10'000;
+    }
+
+    for (const auto& path : files) {
+        if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                run_file(entry.path());
+            }
+        } else {
+            run_file(path);
+        }
+    }
+
+    std::mt19937 rng(seed);
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t n = 0; n < runs; n++) {
+        auto data = random_input(rng, max_ops);
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = std::chrono::duration<double>(elapsed).count();
+
+    std::printf(
+        "%llu inputs, %llu operations (%llu frames), no invariant violated; %.0f random inputs/s\n",
+        static_cast<unsigned long long>(stats.inputs),
+        static_cast<unsigned long long>(stats.ops),
+        static_cast<unsigned long long>(stats.frames),
+        seconds > 0.0 ? runs / seconds : 0.0
+    );
+    report_frame_throughput(rng);
+    return 0;
+}
+
+#endif // LCU_FUZZ_LIBFUZZER
@@ -0,0 +1,202 @@
+#include <cmath>
+#include <cstdio>
+
+#include "Control/MimoLevitation.hpp"
+
+// Closes the 5-DOF levitation loop (Control/MimoLevitation.hpp) on a rigid-body
+// model of the vehicle with MimoLevitation::NOMINAL_GEOMETRY: the airgaps come
+// from the body pose, the LPU currents back from Controller::step() move it. The
+// plant follows the axis conventions documented on MimoLevitation::Axis, written
+// out here rather than through MimoLevitation::kinematics(), so a sign or lever
+// arm that disagrees between sensing, allocation and the body shows up as a loop
+// that does not settle.
+//
+// Every axis has a negative stiffness, as an attraction levitator has around its
+// operating gap: the open loop is unstable. The body masses and the force per
+// ampere are picked so that AXIS_GAINS are stable on it; the run checks the
+// structure of the controller, not the tuning for the vehicle (AXIS_GAINS_TUNED).
+//
+// Pass: every axis back on its reference after a start offset with a weight and a
+// pitch load, and again after a reference step; commands never saturated for long,
+// every current finite.
+//   out/build/simulator/host/mimo_levitation_loop
+
+namespace {
+
+using MimoLevitation::Axis;
+using MimoLevitation::AXIS_COUNT;
+using MimoLevitation::Direction;
+using MimoLevitation::Placement;
+
+constexpr auto& GEOMETRY = MimoLevitation::NOMINAL_GEOMETRY;
+constexpr size_t AIRGAPS = GEOMETRY.airgaps.size();
+constexpr size_t LPUS = GEOMETRY.lpus.size();
+
+using Pose = std::array<double, AXIS_COUNT>;
+
+// ============================================
+// Plant
+// ============================================
+
+constexpr double TICK_S = MimoLevitation::AXIS_PID_CONFIG.sample_time_s;
+constexpr int SUBSTEPS = 100;
+constexpr double DT_S = TICK_S / SUBSTEPS;
+
+constexpr double FORCE_PER_AMPERE = 10.0; // N/A, each magnet toward its rail
+constexpr double CURRENT_LAG_S = 0.5e-3;  // The CURRENT loop, as a first order lag
+constexpr double LATERAL_GAP_M = 0.010;   // Both sides, centred
+
+// Heave, pitch, roll, yaw, lateral: kg or kg*m^2, N/m or N*m/rad
+constexpr Pose INERTIA = {15.0, 4.0, 1.5, 4.0, 15.0};
+constexpr Pose NEGATIVE_STIFFNESS = {3000.0, 1000.0, 400.0, 1000.0, 3000.0};
+constexpr Pose OPERATING_POSE = {0.020, 0.0, 0.0, 0.0, 0.0};
+
+// Weight not carried at the operating gap (opens the gaps) and a pitch load, N and N*m
+constexpr Pose LOAD = {150.0, 5.0, 0.0, 0.0, 0.0};
+
+// d(gap)/d(axis) at placement, from the conventions on Axis
+Pose gap_gradient(const Placement& placement) {
+    Pose gradient{};
+    double x = placement.x_m;
+    double y = placement.y_m;
+    if (placement.direction == Direction::VERTICAL) {
+        gradient[static_cast<size_t>(Axis::HEAVE)] = 1.0;
+        gradient[static_cast<size_t>(Axis::PITCH)] = -x; // Nose up closes the front
+        gradient[static_cast<size_t>(Axis::ROLL)] = y;   // Left down opens the left
+    } else {
+        double side = y > 0.0 ? 1.0 : -1.0;
+        gradient[static_cast<size_t>(Axis::YAW)] = side * x; // Nose right opens front left
+        gradient[static_cast<size_t>(Axis::LATERAL)] = side;
+    }
+    return gradient;
+}
+
+double gap(const Placement& placement, const Pose& pose) {
+    Pose gradient = gap_gradient(placement);
+    double value = placement.direction == Direction::LATERAL ? LATERAL_GAP_M : 0.0;
+    for (size_t a = 0; a < AXIS_COUNT; a++) {
+        value += gradient[a] * pose[a];
+    }
+    return value;
+}
+
+class Vehicle {
+public:
+    explicit Vehicle(const Pose& start) : pose(start) {}
+
+    std::array<float, AIRGAPS> airgaps() const {
+        std::array<float, AIRGAPS> readings{};
+        for (size_t c = 0; c < AIRGAPS; c++) {
+            readings[c] = static_cast<float>(gap(GEOMETRY.airgaps[c], pose));
+        }
+        return readings;
+    }
+
+    // One LEVITATION tick with references held
+    void advance(const std::array<float, LPUS>& references) {
+        for (int s = 0; s < SUBSTEPS; s++) {
+            Pose force = LOAD;
+            for (size_t i = 0; i < LPUS; i++) {
+                currents[i] += (references[i] - currents[i]) * (DT_S / CURRENT_LAG_S);
+                Pose gradient = gap_gradient(GEOMETRY.lpus[i]);
+                for (size_t a = 0; a < AXIS_COUNT; a++) {
+                    force[a] -= FORCE_PER_AMPERE * currents[i] * gradient[a];
+                }
+            }
+            for (size_t a = 0; a < AXIS_COUNT; a++) {
+                force[a] += NEGATIVE_STIFFNESS[a] * (pose[a] - OPERATING_POSE[a]);
+                velocity[a] += force[a] / INERTIA[a] * DT_S;
+                pose[a] += velocity[a] * DT_S;
+            }
+        }
+    }
+
+    Pose pose;
+
+private:
+    Pose velocity{};
+    std::array<double, LPUS> currents{};
+};
+
+// ============================================
+// Run
+// ============================================
+
+constexpr const char* AXIS_NAMES[AXIS_COUNT] = {"heave", "pitch", "roll", "yaw", "lateral"};
+
+constexpr int PHASE_TICKS = 1500;
+constexpr double SETTLED = 2e-5; // m or rad
+// Past this many ticks in a row on a limit the loop is not in control
+constexpr int MAX_SATURATED_TICKS = 50;
+
+struct Phase {
+    const char* name;
+    std::array<float, AXIS_COUNT> reference;
+};
+
+constexpr Phase PHASES[] = {
+    {"start offset", {0.020f, 0.0f, 0.0f, 0.0f, 0.0f}},
+    {"reference step", {0.018f, 0.002f, -0.002f, 0.001f, 0.001f}},
+};
+
+bool saturated(const std::array<float, AXIS_COUNT>& commands) {
+    for (size_t a = 0; a < AXIS_COUNT; a++) {
+        const auto& gains = MimoLevitation::AXIS_GAINS[a];
+        if (commands[a] <= gains.output_min || commands[a] >= gains.output_max) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+static_assert(
+    MimoLevitation::observable(GEOMETRY) && MimoLevitation::controllable(GEOMETRY),
+    "The loop can only close on a geometry the controller accepts"
+);
+
+int main() {
+    MimoLevitation::Controller<AIRGAPS, LPUS> controller{GEOMETRY};
+    Vehicle vehicle{{0.024, 0.004, -0.005, 0.003, 0.002}};
+    std::array<float, LPUS> currents{};
+    bool passed = true;
+
+    for (const auto& phase : PHASES) {
+        int saturated_ticks = 0;
+        for (int tick = 0; tick < PHASE_TICKS; tick++) {
+            controller.step(
+                MimoLevitation::AXIS_GAINS, phase.reference, vehicle.airgaps(), currents
+            );
+            for (float current : currents) {
+                if (!std::isfinite(current)) {
+                    std::printf("FAIL %s: non-finite current at tick %d\n", phase.name, tick);
+                    return 1;
+                }
+            }
+            saturated_ticks = saturated(controller.axis_commands()) ? saturated_ticks + 1 : 0;
+            if (saturated_ticks > MAX_SATURATED_TICKS) {
+                std::printf("FAIL %s: commands saturated at tick %d\n", phase.name, tick);
+                return 1;
+            }
+            vehicle.advance(currents);
+        }
+
+        std::printf("%s:\n", phase.name);
+        for (size_t a = 0; a < AXIS_COUNT; a++) {
+            double error = vehicle.pose[a] - phase.reference[a];
+            bool settled = std::fabs(error) < SETTLED;
+            passed = passed && settled;
+            std::printf(
+                "  %-8s %+.6f (reference %+.6f) %s\n",
+                AXIS_NAMES[a],
+                vehicle.pose[a],
+                phase.reference[a],
+                settled ? "ok" : "NOT SETTLED"
+            );
+        }
+    }
+
+    std::printf(passed ? "Loop closed on every axis\n" : "FAIL: loop did not settle\n");
+    return passed ? 0 : 1;
+}
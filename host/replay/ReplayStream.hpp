@@ -0,0 +1,107 @@
+#ifndef REPLAY_STREAM_HPP
+#define REPLAY_STREAM_HPP
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Telemetry/ReplayCapture.hpp"
+
+// ============================================
+// Replay stream files
+// ============================================
+// A stream file is a ReplayCapture::StreamHeader followed by the records back to
+// back, each a RecordHeader and its payload. tools/replay_capture_receiver.py
+// writes them from the board; lcu_replay writes the same format with --output,
+// so a replayed stream can itself be replayed by another build.
+
+namespace ReplayStream {
+
+using ReplayCapture::Record;
+using ReplayCapture::RecordType;
+using ReplayCapture::StreamHeader;
+
+inline RecordType type_of(const Record& record) {
+    return static_cast<RecordType>(record.header.type);
+}
+
+template <typename Payload> inline Payload payload_of(const Record& record) {
+    Payload payload{};
+    size_t size = std::min(sizeof(payload), size_t{record.header.size});
+    std::memcpy(&payload, record.payload.data(), size);
+    return payload;
+}
+
+/**
+ * @brief Read a whole stream file. Returns false with a message in error when the file
+ * is unreadable, truncated or recorded by a build with a different shape.
+ */
+inline bool read(const char* path, std::vector<Record>& records, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = std::string("Cannot open ") + path;
+        return false;
+    }
+
+    StreamHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+        error = "File too short for a stream header";
+        return false;
+    }
+    if (header.magic != ReplayCapture::MAGIC || header.version != ReplayCapture::VERSION) {
+        error = "Not a version " + std::to_string(ReplayCapture::VERSION) + " replay stream";
+        return false;
+    }
+
+    constexpr StreamHeader expected = ReplayCapture::stream_header();
+    if (header.lpu_count != expected.lpu_count || header.vbat_count != expected.vbat_count ||
+        header.shunt_count != expected.shunt_count ||
+        header.airgap_count != expected.airgap_count ||
+        header.frame_size != expected.frame_size) {
+        char message[160];
+        std::snprintf(
+            message,
+            sizeof(message),
+            "Stream recorded with %u LPUs and a %u-byte frame; this build has %u LPUs and %u bytes",
+            header.lpu_count,
+            header.frame_size,
+            expected.lpu_count,
+            expected.frame_size
+        );
+        error = message;
+        return false;
+    }
+
+    Record record{};
+    while (in.read(reinterpret_cast<char*>(&record.header), sizeof(record.header))) {
+        if (record.header.size > record.payload.size()) {
+            error = "Record of " + std::to_string(record.header.size) + " bytes is too large";
+            return false;
+        }
+        record.payload.fill(0);
+        if (!in.read(reinterpret_cast<char*>(record.payload.data()), record.header.size)) {
+            error = "Truncated record after " + std::to_string(records.size()) + " records";
+            return false;
+        }
+        records.push_back(record);
+    }
+    return true;
+}
+
+inline bool write(const char* path, const std::vector<Record>& records) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    constexpr StreamHeader header = ReplayCapture::stream_header();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& record : records) {
+        out.write(
+            reinterpret_cast<const char*>(&record),
+            static_cast<std::streamsize>(sizeof(record.header) + record.header.size)
+        );
+    }
+    return bool(out);
+}
+
+} // namespace ReplayStream
+
+#endif // REPLAY_STREAM_HPP
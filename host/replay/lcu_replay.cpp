@@ -0,0 +1,342 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+#include "HostBoard.hpp"
+#include "ReplayStream.hpp"
+
+// Replays a capture (tools/replay_capture_receiver.py) through the real
+// Communications, LCU_SM, ControlParameters and Control code and diffs what they do with what the
+// board did. Built by the simulator presets:
+//   cmake --build --preset simulator --target lcu_replay
+//   out/build/simulator/host/lcu_replay capture.lcur [--output replayed.lcur]
+// Exit code 0 when every OUTPUT and TRANSITION record matches, 1 otherwise.
+
+namespace {
+
+using namespace LCU_Slave;
+using ReplayCapture::AdcPayload;
+using ReplayCapture::OutputPayload;
+using ReplayCapture::Record;
+using ReplayCapture::RecordType;
+using ReplayCapture::TransitionPayload;
+using ReplayStream::payload_of;
+using ReplayStream::type_of;
+
+// Background iterations allowed to get one frame through the SPI exchange
+constexpr int MAX_FRAME_STEPS = 8;
+
+struct Options {
+    const char* capture = nullptr;
+    const char* output = nullptr;
+    float tolerance = 1e-4f; // Relative, with an absolute floor of the same size
+    size_t max_reported = 10;
+};
+
+struct Counters {
+    uint64_t ticks = 0;
+    uint64_t frames = 0;
+    uint64_t master_faults = 0;
+    uint64_t parameter_sets = 0;
+    uint64_t gaps = 0;
+    uint32_t first_tick = 0;
+    uint32_t last_tick = 0;
+};
+
+// ============================================
+// Feeding the inputs
+// ============================================
+
+void drain_into(std::vector<Record>& replayed) {
+    Record record;
+    while (ReplayCapture::ring.pop(record)) {
+        replayed.push_back(record);
+    }
+}
+
+// The SENSORS group reads the buffers the DMA left; the other groups follow in the same tick
+void feed_adc(const Record& record) {
+    auto payload = payload_of<AdcPayload>(record);
+    std::ranges::copy(payload.vbat, vbat_buffers.begin());
+    std::ranges::copy(payload.shunt, shunt_buffers.begin());
+    std::ranges::copy(payload.airgap, airgap_buffers.begin());
+
+    ControlExecutive::tick_count = record.header.tick - 1;
+    ControlExecutive::tick();
+}
+
+// Runs the background loop until the frame has been clocked in and decoded
+void feed_frame(const Record& record) {
+    ControlExecutive::tick_count = record.header.tick;
+    HostBoard::spi.reply = record.payload.data();
+    for (int step = 0; step < MAX_FRAME_STEPS; step++) {
+        Communications::update();
+        LCU_SM::update();
+        if (HostBoard::spi.reply == nullptr && !Communications::spi_flag) {
+            return;
+        }
+    }
+}
+
+// Staged now, live at the next tick boundary: the tick whose ADC record follows
+void feed_parameters(const Record& record) {
+    auto set = payload_of<ControlParameters::ParameterSet>(record);
+    auto result = ControlParameters::stage(set);
+    if (result != ControlParameters::Result::STAGED) {
+        std::printf(
+            "Parameter set %u at tick %u not staged (result %u)\n",
+            set.version,
+            record.header.tick,
+            static_cast<unsigned>(result)
+        );
+    }
+}
+
+void feed_master_fault(const Record& record) {
+    ControlExecutive::tick_count = record.header.tick;
+    ReplayCapture::record_master_fault();
+    master_fault_triggered = true;
+    LCU_SM::update();
+}
+
+// ============================================
+// Diff
+// ============================================
+
+bool is_output(const Record& record) {
+    return type_of(record) == RecordType::OUTPUT || type_of(record) == RecordType::TRANSITION;
+}
+
+const char* state_name(uint8_t state) {
+    static constexpr std::array<const char*, 5> names = {
+        "SPI_CONNECTING", "IDLE", "CURRENT_CONTROL", "LEVITATING", "FAULT"
+    };
+    return state < names.size() ? names[state] : "?";
+}
+
+std::string describe(const Record& record) {
+    char text[256];
+    if (type_of(record) == RecordType::TRANSITION) {
+        auto transition = payload_of<TransitionPayload>(record);
+        std::snprintf(
+            text,
+            sizeof(text),
+            "tick %u TRANSITION %s -> %s flags 0x%04x",
+            record.header.tick,
+            state_name(transition.from),
+            state_name(transition.to),
+            transition.command_flags
+        );
+        return text;
+    }
+    auto output = payload_of<OutputPayload>(record);
+    int length = std::snprintf(
+        text,
+        sizeof(text),
+        "tick %u OUTPUT %s enabled 0x%04x target %.6g V duty",
+        record.header.tick,
+        state_name(output.state),
+        output.enabled_mask,
+        output.target_voltage
+    );
+    for (float duty : output.duty) {
+        if (length > 0 && static_cast<size_t>(length) < sizeof(text)) {
+            length += std::snprintf(text + length, sizeof(text) - length, " %.4g", duty);
+        }
+    }
+    return text;
+}
+
+bool close_enough(float a, float b, float tolerance) {
+    return std::fabs(a - b) <= tolerance * std::max({1.0f, std::fabs(a), std::fabs(b)});
+}
+
+bool same(const Record& captured, const Record& replayed, float tolerance) {
+    if (captured.header.type != replayed.header.type) {
+        return false;
+    }
+    if (type_of(captured) == RecordType::TRANSITION) {
+        auto a = payload_of<TransitionPayload>(captured);
+        auto b = payload_of<TransitionPayload>(replayed);
+        return a.from == b.from && a.to == b.to && a.command_flags == b.command_flags;
+    }
+    auto a = payload_of<OutputPayload>(captured);
+    auto b = payload_of<OutputPayload>(replayed);
+    if (a.state != b.state || a.enabled_mask != b.enabled_mask ||
+        !close_enough(a.target_voltage, b.target_voltage, tolerance)) {
+        return false;
+    }
+    for (size_t i = 0; i < a.duty.size(); i++) {
+        if (!close_enough(a.duty[i], b.duty[i], tolerance)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the number of mismatches. Tick differences alone are counted, not failed:
+// a control tick between two background steps on the board can move a transition by one.
+size_t diff(
+    const std::vector<Record>& captured,
+    const std::vector<Record>& replayed,
+    const Options& options
+) {
+    std::vector<const Record*> expected;
+    std::vector<const Record*> actual;
+    for (const auto& record : captured) {
+        if (is_output(record)) {
+            expected.push_back(&record);
+        }
+    }
+    for (const auto& record : replayed) {
+        if (is_output(record)) {
+            actual.push_back(&record);
+        }
+    }
+
+    size_t mismatches = 0;
+    size_t tick_offsets = 0;
+    size_t common = std::min(expected.size(), actual.size());
+    for (size_t i = 0; i < common; i++) {
+        if (expected[i]->header.tick != actual[i]->header.tick) {
+            tick_offsets++;
+        }
+        if (same(*expected[i], *actual[i], options.tolerance)) {
+            continue;
+        }
+        if (mismatches < options.max_reported) {
+            std::printf("Mismatch at output %zu\n", i);
+            std::printf("  board:  %s\n", describe(*expected[i]).c_str());
+            std::printf("  replay: %s\n", describe(*actual[i]).c_str());
+        }
+        mismatches++;
+    }
+
+    if (expected.size() != actual.size()) {
+        std::printf("Board produced %zu outputs, replay %zu\n", expected.size(), actual.size());
+        mismatches += std::max(expected.size(), actual.size()) - common;
+    }
+    std::printf(
+        "%zu outputs compared, %zu mismatches, %zu at a different tick\n",
+        common,
+        mismatches,
+        tick_offsets
+    );
+    return mismatches;
+}
+
+bool parse(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string_view arg = argv[i];
+        if (arg == "--output" && i + 1 < argc) {
+            options.output = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            options.tolerance = std::strtof(argv[++i], nullptr);
+        } else if (arg == "--max-reported" && i + 1 < argc) {
+            options.max_reported = std::strtoul(argv[++i], nullptr, 10);
+        } else if (!arg.starts_with("--") && options.capture == nullptr) {
+            options.capture = argv[i];
+        } else {
+            return false;
+        }
+    }
+    return options.capture != nullptr;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::fprintf(
+            stderr,
+            "Usage: %s <capture.lcur> [--output <file>] [--tolerance <relative>] "
+            "[--max-reported <n>]\n",
+            argv[0]
+        );
+        return 1;
+    }
+
+    std::vector<Record> captured;
+    std::string error;
+    if (!ReplayStream::read(options.capture, captured, error)) {
+        std::fprintf(stderr, "%s: %s\n", options.capture, error.c_str());
+        return 1;
+    }
+
+    HostBoard::init();
+
+    std::vector<Record> replayed;
+    replayed.reserve(captured.size());
+    Counters counters;
+    bool first_tick = true;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& record : captured) {
+        switch (type_of(record)) {
+        case RecordType::ADC:
+            feed_adc(record);
+            if (first_tick) {
+                counters.first_tick = record.header.tick;
+                first_tick = false;
+            }
+            counters.last_tick = record.header.tick;
+            counters.ticks++;
+            break;
+        case RecordType::FRAME:
+            feed_frame(record);
+            counters.frames++;
+            break;
+        case RecordType::MASTER_FAULT:
+            feed_master_fault(record);
+            counters.master_faults++;
+            break;
+        case RecordType::PARAMETERS:
+            feed_parameters(record);
+            counters.parameter_sets++;
+            break;
+        case RecordType::GAP:
+            std::printf(
+                "Records lost after tick %u; outputs after it may differ\n",
+                counters.last_tick
+            );
+            replayed.push_back(record);
+            counters.gaps++;
+            break;
+        case RecordType::OUTPUT:
+        case RecordType::TRANSITION:
+        default:
+            break;
+        }
+        drain_into(replayed);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double simulated =
+        (counters.last_tick - counters.first_tick) * ControlExecutive::BASE_PERIOD_US * 1e-6;
+    std::printf(
+        "Replayed %llu ticks (%.3f s), %llu frames, %llu master faults, %llu parameter sets, "
+        "%llu gaps in %.3f s (%.0fx real time)\n",
+        static_cast<unsigned long long>(counters.ticks),
+        simulated,
+        static_cast<unsigned long long>(counters.frames),
+        static_cast<unsigned long long>(counters.master_faults),
+        static_cast<unsigned long long>(counters.parameter_sets),
+        static_cast<unsigned long long>(counters.gaps),
+        elapsed,
+        elapsed > 0.0 ? simulated / elapsed : 0.0
+    );
+    std::printf(
+        "Final state %s\n",
+        state_name(static_cast<uint8_t>(LCU_SM::sm_operational.get_current_state()))
+    );
+
+    if (options.output != nullptr && !ReplayStream::write(options.output, replayed)) {
+        std::fprintf(stderr, "Cannot write %s\n", options.output);
+        return 1;
+    }
+
+    return diff(captured, replayed, options) == 0 ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Run the host benchmarks (host/benchmarks/lcu_benchmarks.cpp) and fail on regressions.
+
+Compares every benchmark against a stored baseline and exits non-zero when one got
+slower than the threshold allows. Instruction counts are compared by default; they
+are stable across runs on the same compiler. Wall time (--metric ns) is only
+meaningful against a baseline recorded on the same machine.
+
+Exit codes: 0 pass, 1 regression or error, 77 skipped (no baseline, or the metric
+is unavailable on this machine), so ctest can report the gate as skipped.
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import subprocess
+import sys
+import tempfile
+from pathlib import Path
+
+
+SKIPPED = 77
+METRICS = {"instructions": "instructions_per_op", "ns": "ns_per_op"}
+
+
+def run_benchmarks(executable: Path, repetitions: int | None) -> dict:
+    with tempfile.TemporaryDirectory() as directory:
+        output = Path(directory) / "results.json"
+        command = [str(executable.resolve()), "--json", str(output)]
+        if repetitions is not None:
+            command += ["--repetitions", str(repetitions)]
+        subprocess.run(command, check=True)
+        return json.loads(output.read_text())
+
+
+def compare(baseline: dict, current: dict, key: str, threshold: float) -> tuple[list[str], bool]:
+    """Return (report lines, passed)."""
+    lines = []
+    passed = True
+    for name, result in current["benchmarks"].items():
+        before = baseline["benchmarks"].get(name, {}).get(key)
+        after = result.get(key)
+        if before is None or after is None:
+            lines.append(f"  {name:<34} {'new' if before is None else 'n/a':>10}")
+            continue
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        verdict = "ok"
+        if change > threshold:
+            verdict = "REGRESSION"
+            passed = False
+        elif change < -threshold:
+            verdict = "faster (update the baseline)"
+        lines.append(f"  {name:<34} {before:>10.1f} -> {after:>10.1f} {change:+7.1f}%  {verdict}")
+    for name in baseline["benchmarks"].keys() - current["benchmarks"].keys():
+        lines.append(f"  {name:<34} missing from this run")
+    return lines, passed
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--benchmark", type=Path, help="lcu_benchmarks executable to run")
+    source.add_argument("--results", type=Path, help="Existing --json output to check instead")
+    parser.add_argument(
+        "--baseline", type=Path, required=True, help="Baseline JSON to compare with"
+    )
+    parser.add_argument("--metric", choices=METRICS, default="instructions")
+    parser.add_argument(
+        "--threshold", type=float, default=10.0, help="Allowed slowdown per benchmark, in percent"
+    )
+    parser.add_argument("--repetitions", type=int, help="Forwarded to the benchmark")
+    parser.add_argument(
+        "--update", action="store_true", help="Store this run as the new baseline and exit"
+    )
+    args = parser.parse_args()
+
+    try:
+        if args.results:
+            current = json.loads(args.results.read_text())
+        else:
+            current = run_benchmarks(args.benchmark, args.repetitions)
+    except (OSError, ValueError, subprocess.CalledProcessError) as error:
+        print(error, file=sys.stderr)
+        return 1
+
+    if args.update:
+        args.baseline.write_text(json.dumps(current, indent=2) + "\n")
+        print(f"Baseline written to {args.baseline}")
+        return 0
+
+    if not args.baseline.exists():
+        print(f"No baseline at {args.baseline}; record one with --update")
+        return SKIPPED
+    baseline = json.loads(args.baseline.read_text())
+    if baseline.get("dof") != current.get("dof"):
+        print(f"Baseline is for {baseline.get('dof')} DOF, this build is {current.get('dof')} DOF")
+        return 1
+
+    key = METRICS[args.metric]
+    if all(result.get(key) is None for result in current["benchmarks"].values()):
+        print(f"No {args.metric} figures in this run (perf events unavailable?)")
+        return SKIPPED
+
+    lines, passed = compare(baseline, current, key, args.threshold)
+    print(f"{args.metric} per call, threshold {args.threshold:.0f}%:")
+    print("\n".join(lines))
+    if not passed:
+        print("Benchmark regression: a hot path got slower than the threshold allows")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+"""Load controller parameter sets into a running board (Core/Inc/Control/ControlParameters.hpp).
+
+Field names come from the parameter struct of the generated model (P_control_T in
+deps/LCU-Control-H11/control.h) and from the gains of the native loops (PidGains in
+Core/Inc/Control/Pid.hpp): "current_pi.<field>" for the current loop and
+"levitation.<axis>.<field>" for the 5-DOF levitation axes. A set is sent as word writes
+into control_P, Control::current_gains or Control::levitation_gains.
+
+Set datagram, host -> board (little endian):
+    uint16 id (0xFFFB) | uint32 sequence | uint32 version | uint32 count | write[8]
+    write: uint8 block | uint8 reserved | uint16 offset | uint32 value
+Status datagram, board -> host:
+    uint16 id (0xFFFA) | uint32 sequence | uint32 result | uint32 active_version
+    | uint32 applied | uint32 rejected
+
+Examples:
+    python3 tools/control_parameters.py list
+    python3 tools/control_parameters.py set --version 3 Kp=12.5 Ki=4000
+    python3 tools/control_parameters.py set --version 4 current_pi.kp=8 current_pi.ki=900
+    python3 tools/control_parameters.py set --version 5 levitation.heave.kd=45
+    python3 tools/control_parameters.py status
+"""
+from __future__ import annotations
+
+import argparse
+import re
+import socket
+import struct
+import sys
+import time
+from pathlib import Path
+
+
+SET_ID = 0xFFFB
+STATUS_ID = 0xFFFA
+MAX_WRITES = 8
+MODEL_BLOCK = 0
+CURRENT_PI_BLOCK = 1
+CURRENT_PI_PREFIX = "current_pi."
+LEVITATION_AXES_BLOCK = 2
+# MimoLevitation::Axis order
+LEVITATION_AXES = ["heave", "pitch", "roll", "yaw", "lateral"]
+
+WRITE = struct.Struct("<BBHI")
+SET_HEADER = struct.Struct("<HIII")
+STATUS = struct.Struct("<HIIIII")
+
+RESULTS = [
+    "STAGED",
+    "BUSY",
+    "BAD_VERSION",
+    "TOO_MANY_WRITES",
+    "BAD_BLOCK",
+    "BAD_OFFSET",
+    "SCHEDULED",
+]
+
+# Simulink/C type -> (struct format, size); alignment equals size
+TYPES = {
+    "real32_T": ("f", 4),
+    "float": ("f", 4),
+    "real_T": ("d", 8),
+    "double": ("d", 8),
+    "int32_T": ("i", 4),
+    "uint32_T": ("I", 4),
+    "int16_T": ("h", 2),
+    "uint16_T": ("H", 2),
+    "int8_T": ("b", 1),
+    "uint8_T": ("B", 1),
+    "boolean_T": ("B", 1),
+}
+
+FIELD = re.compile(r"^\s*(\w+)\s+(\w+)\s*(?:\[(\d+)\])?\s*;")
+
+
+class Field:
+    def __init__(self, name: str, type_name: str, offset: int, length: int, block: int):
+        self.name = name
+        self.type_name = type_name
+        self.format, self.size = TYPES[type_name]
+        self.offset = offset
+        self.length = length
+        self.block = block
+
+
+def parse_struct(
+    header: Path, struct_name: str, block: int, prefix: str = "", hint: str = ""
+) -> list[Field]:
+    """Lay out struct_name with natural alignment, as the firmware compiler does."""
+    text = re.sub(r"/\*.*?\*/", "", header.read_text(), flags=re.S)
+    text = re.sub(r"//[^\n]*", "", text)
+    match = re.search(rf"struct\s+{struct_name}\s*\{{(.*?)\}}\s*;", text, flags=re.S)
+    if match is None:
+        raise SystemExit(f"{header}: no struct {struct_name}{hint}")
+
+    fields = []
+    offset = 0
+    for line in match.group(1).splitlines():
+        if not line.strip():
+            continue
+        field = FIELD.match(line)
+        if field is None or field.group(1) not in TYPES:
+            raise SystemExit(f"{header}: unsupported parameter declaration: {line.strip()}")
+        type_name, name, length = field.group(1), field.group(2), int(field.group(3) or 1)
+        size = TYPES[type_name][1]
+        offset = (offset + size - 1) // size * size
+        fields.append(Field(prefix + name, type_name, offset, length, block))
+        offset += size * length
+    return fields
+
+
+def parse_parameters(header: Path, model: str, pid_header: Path) -> list[Field]:
+    """Fields of every block a set can write, model parameters first."""
+    fields = parse_struct(
+        header, f"P_{model}_T_", MODEL_BLOCK, hint=" (are the parameters inlined?)"
+    )
+    fields += parse_struct(pid_header, "PidGains", CURRENT_PI_BLOCK, CURRENT_PI_PREFIX)
+
+    gains = parse_struct(pid_header, "PidGains", LEVITATION_AXES_BLOCK)
+    gains_size = max(field.offset + field.size * field.length for field in gains)
+    for axis_index, axis in enumerate(LEVITATION_AXES):
+        for field in gains:
+            fields.append(
+                Field(
+                    f"levitation.{axis}.{field.name}",
+                    field.type_name,
+                    axis_index * gains_size + field.offset,
+                    field.length,
+                    LEVITATION_AXES_BLOCK,
+                )
+            )
+    return fields
+
+
+def resolve(fields: list[Field], assignment: str) -> list[tuple[int, int, int]]:
+    """NAME=VALUE or NAME[i]=VALUE -> list of (block, offset, raw word)."""
+    target, _, value = assignment.partition("=")
+    match = re.fullmatch(r"([\w.]+)(?:\[(\d+)\])?", target.strip())
+    if not value or match is None:
+        raise SystemExit(f"Expected NAME=VALUE or NAME[i]=VALUE, got '{assignment}'")
+    name, index = match.group(1), int(match.group(2) or 0)
+
+    field = next((f for f in fields if f.name == name), None)
+    if field is None:
+        raise SystemExit(f"No parameter '{name}' (see the list command)")
+    if index >= field.length:
+        raise SystemExit(f"{name} has {field.length} elements")
+    if field.size < 4:
+        raise SystemExit(f"{name} is {field.type_name}: only 32- and 64-bit parameters can be set")
+
+    number = float(value) if field.format in "fd" else int(value, 0)
+    raw = struct.pack("<" + field.format, number)
+    offset = field.offset + index * field.size
+    return [
+        (field.block, offset + i, struct.unpack_from("<I", raw, i)[0])
+        for i in range(0, field.size, 4)
+    ]
+
+
+def exchange(args, sequence: int, version: int, writes: list[tuple[int, int, int]]):
+    """Send one set datagram and wait for the status that answers it."""
+    payload = b"".join(WRITE.pack(block, 0, offset, value) for block, offset, value in writes)
+    payload += bytes(WRITE.size * (MAX_WRITES - len(writes)))
+    datagram = SET_HEADER.pack(SET_ID, sequence, version, len(writes)) + payload
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.port))
+    sock.settimeout(0.2)
+    deadline = time.monotonic() + args.timeout
+    answer = None
+    try:
+        sock.sendto(datagram, (args.board_ip, args.port))
+        while time.monotonic() < deadline:
+            try:
+                data, _ = sock.recvfrom(2048)
+            except socket.timeout:
+                continue
+            if len(data) < STATUS.size or struct.unpack_from("<H", data)[0] != STATUS_ID:
+                continue
+            _, answered, result, active, applied, rejected = STATUS.unpack_from(data)
+            if answered == sequence:
+                answer = {"result": result, "active": active, "applied": applied, "rejected": rejected}
+            # A set goes live at the next tick boundary, one status after the answer
+            if answer is not None and (version == 0 or result != 0 or active == version):
+                return answer
+    finally:
+        sock.close()
+    return answer
+
+
+def new_sequence() -> int:
+    return (int(time.time() * 1000) & 0xFFFFFFFF) or 1
+
+
+def report(answer) -> int:
+    if answer is None:
+        print("No answer from the board", file=sys.stderr)
+        return 1
+    result = answer["result"]
+    name = RESULTS[result] if result < len(RESULTS) else str(result)
+    print(
+        f"result {name}, active version {answer['active']}, "
+        f"{answer['applied']} sets applied, {answer['rejected']} rejected since boot"
+    )
+    return 0 if result == 0 else 1
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument(
+        "--header",
+        type=Path,
+        default=Path("deps/LCU-Control-H11/control.h"),
+        help="Generated model header with the parameter struct",
+    )
+    parser.add_argument("--model", default="control", help="Model name (struct P_<model>_T_)")
+    parser.add_argument(
+        "--pid-header",
+        type=Path,
+        default=Path("Core/Inc/Control/Pid.hpp"),
+        help="Header with struct PidGains (native current loop)",
+    )
+    parser.add_argument("--board-ip", default="192.168.1.7", help="LCU_BOARD_IP")
+    parser.add_argument("--port", type=int, default=50403, help="CONTROL_PARAMETERS_PORT")
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--timeout", type=float, default=2.0, help="Seconds to wait for the board")
+    commands = parser.add_subparsers(dest="command", required=True)
+    commands.add_parser("list", help="List the tunable parameters and their offsets")
+    commands.add_parser("status", help="Ask the board for the active version")
+    set_parser = commands.add_parser("set", help="Load a parameter set")
+    set_parser.add_argument("--version", type=int, required=True, help="Non-zero version of the set")
+    set_parser.add_argument("assignments", nargs="+", metavar="NAME=VALUE")
+    args = parser.parse_args()
+
+    if args.command == "status":
+        return report(exchange(args, new_sequence(), 0, []))
+
+    fields = parse_parameters(args.header, args.model, args.pid_header)
+    if args.command == "list":
+        for field in fields:
+            suffix = f"[{field.length}]" if field.length > 1 else ""
+            print(f"{field.block:3d} {field.offset:6d}  {field.type_name:10s} {field.name}{suffix}")
+        return 0
+
+    if args.version == 0:
+        raise SystemExit("Version 0 is the compiled-in set")
+    writes = [write for assignment in args.assignments for write in resolve(fields, assignment)]
+    if len(writes) > MAX_WRITES:
+        raise SystemExit(
+            f"{len(writes)} words to write, at most {MAX_WRITES} per set: split into several versions"
+        )
+    return report(exchange(args, new_sequence(), args.version, writes))
+
+
+if __name__ == "__main__":
+    sys.exit(main())
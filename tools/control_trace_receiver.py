@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""Receive full-rate control traces (Core/Inc/Telemetry/ControlTrace.hpp) and write them as CSV.
+
+Datagram (little endian):
+    header: uint16 id (0xFFFE) | uint8 lpu_count | uint8 airgap_count | uint16 sample_count
+            | uint16 sample_size | uint32 sequence | uint32 dropped
+    sample: uint32 cycles | uint32 tick | uint32 parameter_version | float target_voltage
+            | float current[lpu_count] | float duty[lpu_count] | float airgap[airgap_count]
+"""
+from __future__ import annotations
+
+import argparse
+import csv
+import socket
+import struct
+import sys
+from pathlib import Path
+
+
+TRACE_ID = 0xFFFE
+HEADER = struct.Struct("<HBBHHII")
+
+
+def sample_struct(lpu_count: int, airgap_count: int) -> struct.Struct:
+    return struct.Struct("<IIIf" + "f" * (2 * lpu_count + airgap_count))
+
+
+def csv_columns(lpu_count: int, airgap_count: int) -> list[str]:
+    columns = ["sequence", "cycles", "tick", "parameter_version", "target_voltage"]
+    columns += [f"current_{i}" for i in range(lpu_count)]
+    columns += [f"duty_{i}" for i in range(lpu_count)]
+    columns += [f"airgap_{i}" for i in range(airgap_count)]
+    return columns
+
+
+def decode_datagram(datagram: bytes):
+    """Return (header fields, list of sample tuples)."""
+    if len(datagram) < HEADER.size:
+        raise ValueError(f"Datagram too short: {len(datagram)} bytes")
+    trace_id, lpu_count, airgap_count, sample_count, sample_size, sequence, dropped = HEADER.unpack_from(datagram)
+    if trace_id != TRACE_ID:
+        raise ValueError(f"Not a trace datagram (id 0x{trace_id:04x})")
+    layout = sample_struct(lpu_count, airgap_count)
+    if layout.size != sample_size:
+        raise ValueError(f"Sample size mismatch: board {sample_size}, expected {layout.size}")
+    if HEADER.size + sample_count * sample_size > len(datagram):
+        raise ValueError("Truncated datagram")
+
+    samples = [layout.unpack_from(datagram, HEADER.size + i * sample_size) for i in range(sample_count)]
+    header = {
+        "lpu_count": lpu_count,
+        "airgap_count": airgap_count,
+        "sequence": sequence,
+        "dropped": dropped,
+    }
+    return header, samples
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=50400, help="UDP port (CONTROL_TRACE_PORT)")
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--output", type=Path, required=True, help="CSV file to write")
+    parser.add_argument("--count", type=int, default=0, help="Stop after this many samples (0 = until Ctrl+C)")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1024 * 1024)
+    sock.bind((args.bind, args.port))
+
+    written = 0
+    lost_datagrams = 0
+    expected_sequence = None
+    last_dropped = 0
+    writer = None
+    with args.output.open("w", newline="") as output:
+        try:
+            while args.count == 0 or written < args.count:
+                datagram, _ = sock.recvfrom(65535)
+                try:
+                    header, samples = decode_datagram(datagram)
+                except ValueError as error:
+                    print(f"Skipping datagram: {error}", file=sys.stderr)
+                    continue
+
+                if writer is None:
+                    writer = csv.writer(output)
+                    writer.writerow(csv_columns(header["lpu_count"], header["airgap_count"]))
+                if expected_sequence is not None and header["sequence"] != expected_sequence:
+                    lost_datagrams += (header["sequence"] - expected_sequence) & 0xFFFFFFFF
+                expected_sequence = (header["sequence"] + 1) & 0xFFFFFFFF
+                last_dropped = header["dropped"]
+
+                for sample in samples:
+                    writer.writerow([header["sequence"], *sample])
+                written += len(samples)
+        except KeyboardInterrupt:
+            pass
+
+    print(
+        f"{written} samples written to {args.output}, "
+        f"{lost_datagrams} datagrams lost on the network, {last_dropped} samples dropped on the board"
+    )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
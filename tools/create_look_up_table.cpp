@@ -1,9 +1,13 @@
 #include <cmath>
+#include <cstdio>
 #include <fstream>
 #include <functional>
 #include <iostream>
 #include <string>
+#include <vector>
 // execute this code to create a LUT in a .hpp
+//   create_look_up_table                       -> look_up_table.hpp (function LUT)
+//   create_look_up_table gain-schedule [path]  -> Core/Inc/Control/LevitationGainSchedule.hpp
 //  Settings
 /*Modify this variables to change the  LUT*/
 constexpr int NUMBER_POINTS = 4096;
@@ -12,7 +16,31 @@ constexpr float END_RAD = 2 * M_PI;
 const std::string FUNC_NAME = "sin";
 std::function<float(float)> func = [](float x) { return std::sin(x); };
 
-int main() {
+/*Modify this variables to change the levitation gain schedule (Control/GainSchedule.hpp)*/
+// The heave axis of the 5-DOF levitation loop (Control/MimoLevitation.hpp), scheduled
+// over its coordinate: the mean vertical gap.
+constexpr int GAP_POINTS = 33;
+constexpr float GAP_MIN_M = 0.010f;
+constexpr float GAP_MAX_M = 0.030f;
+constexpr float GAP_NOMINAL_M = 0.020f; // Operating point the axis gains were designed at
+const std::string SCHEDULED_AXIS = "HEAVE"; // MimoLevitation::Axis
+
+struct ScheduledGain {
+    std::string parameter; // Field of PidGains (Control/Pid.hpp)
+    float nominal;         // MimoLevitation::AXIS_GAINS value, designed at GAP_NOMINAL_M
+    std::function<float(float)> scale; // Gain / nominal at a gap, 1 at GAP_NOMINAL_M
+};
+
+// At constant lift F = k (i / g)^2 the force per ampere is 2F / i, which falls as
+// 1 / g: gains in A/m that grow with g keep the loop gain of the design point.
+// Keep the nominals equal to the heave gains of MimoLevitation::AXIS_GAINS.
+const std::vector<ScheduledGain> SCHEDULED_GAINS = {
+    {"kp", 1500.0f, [](float gap) { return gap / GAP_NOMINAL_M; }},
+    {"ki", 15000.0f, [](float gap) { return gap / GAP_NOMINAL_M; }},
+    {"kd", 40.0f, [](float gap) { return gap / GAP_NOMINAL_M; }},
+};
+
+int write_function_table() {
     std::ofstream out_file("look_up_table.hpp", std::ios::out | std::ios::trunc);
     if (!out_file) {
         std::cerr << "Error al abrir look_up_table.hpp\n";
@@ -40,3 +68,75 @@ int main() {
     out_file << "};\n";
     return 0;
 }
+
+// Round-trips the float exactly and always reads as a float literal
+std::string float_literal(float value) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%.9g", value);
+    std::string literal = text;
+    if (literal.find_first_of(".e") == std::string::npos) {
+        literal += ".0";
+    }
+    return literal + "f";
+}
+
+// A GainTable over the airgap and the PidGains fields its columns go to
+int write_gain_schedule(const std::string& path) {
+    std::ofstream out_file(path, std::ios::out | std::ios::trunc);
+    if (!out_file) {
+        std::cerr << "Cannot open " << path << "\n";
+        return 1;
+    }
+
+    const size_t columns = SCHEDULED_GAINS.size();
+    out_file << "#ifndef LEVITATION_GAIN_SCHEDULE_HPP\n#define LEVITATION_GAIN_SCHEDULE_HPP\n\n";
+    out_file << "// Generated by tools/create_look_up_table.cpp (gain-schedule): do not edit\n\n";
+    out_file << "#include \"Control/GainSchedule.hpp\"\n";
+    out_file << "#include \"Control/MimoLevitation.hpp\"\n";
+    out_file << "#include \"Control/Pid.hpp\"\n\n";
+    out_file << "namespace LevitationGainSchedule {\n\n";
+    out_file << "// Levitation axis whose gains (Control::levitation_gains) are scheduled\n";
+    out_file << "inline constexpr MimoLevitation::Axis AXIS = MimoLevitation::Axis::"
+             << SCHEDULED_AXIS << ";\n\n";
+
+    out_file << "// Airgap " << GAP_MIN_M << " to " << GAP_MAX_M << " m, designed at "
+             << GAP_NOMINAL_M << " m. Columns:\n//";
+    for (const auto& gain : SCHEDULED_GAINS) {
+        out_file << " " << gain.parameter;
+    }
+    out_file << "\n";
+    out_file << "inline constexpr GainTable<" << GAP_POINTS << ", " << columns << "> TABLE{\n";
+    out_file << "    " << float_literal(GAP_MIN_M) << ",\n    " << float_literal(GAP_MAX_M)
+             << ",\n    {{\n";
+    for (int i = 0; i < GAP_POINTS; ++i) {
+        float gap = GAP_MIN_M + (GAP_MAX_M - GAP_MIN_M) * i / (GAP_POINTS - 1);
+        out_file << "        {";
+        for (size_t c = 0; c < columns; ++c) {
+            const auto& gain = SCHEDULED_GAINS[c];
+            out_file << float_literal(gain.nominal * gain.scale(gap))
+                     << (c + 1 != columns ? ", " : "");
+        }
+        out_file << "}, // " << gap << " m\n";
+    }
+    out_file << "    }},\n};\n\n";
+
+    out_file << "inline constexpr std::array<float PidGains::*, " << columns << "> TARGETS = {\n";
+    for (const auto& gain : SCHEDULED_GAINS) {
+        out_file << "    &PidGains::" << gain.parameter << ",\n";
+    }
+    out_file << "};\n\n";
+
+    out_file << "using Schedule = GainSchedule<TABLE, TARGETS>;\n\n";
+    out_file << "} // namespace LevitationGainSchedule\n\n";
+    out_file << "#endif // LEVITATION_GAIN_SCHEDULE_HPP\n";
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "gain-schedule") {
+        return write_gain_schedule(
+            argc > 2 ? argv[2] : "Core/Inc/Control/LevitationGainSchedule.hpp"
+        );
+    }
+    return write_function_table();
+}
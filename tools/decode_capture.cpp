@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include "PacketCodec.hpp"
+// Decode a raw capture of back-to-back data packets with the generated host codec.
+// The codec is generated next to the board headers by Generator.py:
+//   g++ -std=c++20 -O2 -I out/codec/<BOARD_NAME> tools/decode_capture.cpp -o decode_capture
+//   ./decode_capture capture.bin
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <capture.bin>\n";
+        return 1;
+    }
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << argv[1] << "\n";
+        return 1;
+    }
+    std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    std::map<uint16_t, uint64_t> count_by_id;
+    auto start = std::chrono::steady_clock::now();
+    size_t consumed = packet_codec::data::decode_stream(
+        bytes,
+        [&](const packet_codec::data::Any& packet) {
+            std::visit(
+                [&](const auto& decoded) {
+                    if constexpr (!std::is_same_v<std::decay_t<decltype(decoded)>, std::monostate>) {
+                        count_by_id[decoded.ID]++;
+                    }
+                },
+                packet
+            );
+        }
+    );
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t total = 0;
+    for (auto [id, count] : count_by_id) {
+        total += count;
+        std::cout << "id " << id << ": " << count << " packets\n";
+    }
+    std::cout << packet_codec::BOARD_NAME << ": " << total << " packets, " << consumed << "/"
+              << bytes.size() << " bytes decoded";
+    if (elapsed > 0.0) {
+        std::cout << " (" << (consumed / elapsed) / 1e6 << " MB/s)";
+    }
+    std::cout << "\n";
+    return 0;
+}
@@ -12,26 +12,15 @@ import time
 from pathlib import Path
 
 
-TYPE_LAYOUT = {
-    "bool": ("?", 1),
-    "uint8": ("B", 1),
-    "uint16": ("H", 2),
-    "uint32": ("I", 4),
-    "uint64": ("Q", 8),
-    "int8": ("b", 1),
-    "int16": ("h", 2),
-    "int32": ("i", 4),
-    "int64": ("q", 8),
-    "float32": ("f", 4),
-    "float64": ("d", 8),
-    "enum": ("B", 1),
-}
-
-
 def repo_root() -> Path:
     return Path(__file__).resolve().parents[1]
 
 
+# Field layouts come from the packet generator, so they cannot drift from the firmware
+sys.path.insert(0, str(repo_root() / "Core/Inc/Code_generation"))
+from Packet_generation.Packet_generation import json_type_layout  # noqa: E402
+
+
 class Schema:
     def __init__(self, board_name: str):
         json_root = repo_root() / "Core/Inc/Code_generation/JSON_ADE"
@@ -78,7 +67,7 @@ class Schema:
 
     def field_layout(self, field_name: str) -> tuple[str, int]:
         measurement = self.measurements[field_name]
-        return TYPE_LAYOUT[measurement["type"]]
+        return json_type_layout(measurement["type"])
 
     def packet_size(self, definition: dict) -> int:
         total = 2
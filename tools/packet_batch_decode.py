@@ -0,0 +1,85 @@
+#!/usr/bin/env python3
+"""Split batched DataPackets datagrams (Core/Inc/Communications/PacketBatch.hpp).
+
+Wire format (little endian):
+    uint16 BATCH_ID (0xFFFF) | uint8 count | count x { uint16 length | packet bytes }
+Any other datagram is a single packet and is returned as is.
+"""
+from __future__ import annotations
+
+import argparse
+import socket
+import struct
+import sys
+from pathlib import Path
+
+
+BATCH_ID = 0xFFFF
+HEADER = struct.Struct("<HB")
+SUB_HEADER = struct.Struct("<H")
+PACKET_ID = struct.Struct("<H")
+
+
+def split_datagram(datagram: bytes) -> list[bytes]:
+    """Return the packets carried by one datagram, each starting with its uint16 id."""
+    if len(datagram) < PACKET_ID.size:
+        raise ValueError(f"Datagram too short: {len(datagram)} bytes")
+    (packet_id,) = PACKET_ID.unpack_from(datagram)
+    if packet_id != BATCH_ID:
+        return [datagram]
+
+    if len(datagram) < HEADER.size:
+        raise ValueError("Truncated batch header")
+    _, count = HEADER.unpack_from(datagram)
+    offset = HEADER.size
+    packets = []
+    for index in range(count):
+        if offset + SUB_HEADER.size > len(datagram):
+            raise ValueError(f"Truncated sub-header for packet {index}")
+        (length,) = SUB_HEADER.unpack_from(datagram, offset)
+        offset += SUB_HEADER.size
+        if length < PACKET_ID.size or offset + length > len(datagram):
+            raise ValueError(f"Invalid length {length} for packet {index}")
+        packets.append(datagram[offset : offset + length])
+        offset += length
+    if offset != len(datagram):
+        raise ValueError(f"{len(datagram) - offset} trailing bytes after {count} packets")
+    return packets
+
+
+def packet_id(packet: bytes) -> int:
+    return PACKET_ID.unpack_from(packet)[0]
+
+
+def print_packets(packets: list[bytes]) -> None:
+    for packet in packets:
+        print(f"id={packet_id(packet)} len={len(packet)} payload={packet[PACKET_ID.size:].hex()}")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--file", type=Path, help="Raw datagram captured to a file")
+    source.add_argument("--listen", type=int, metavar="PORT", help="UDP port to receive on")
+    parser.add_argument("--bind", default="0.0.0.0", help="Address for --listen")
+    args = parser.parse_args()
+
+    if args.file is not None:
+        print_packets(split_datagram(args.file.read_bytes()))
+        return 0
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.bind((args.bind, args.listen))
+    try:
+        while True:
+            datagram, _ = sock.recvfrom(65535)
+            try:
+                print_packets(split_datagram(datagram))
+            except ValueError as error:
+                print(f"Malformed datagram: {error}", file=sys.stderr)
+    except KeyboardInterrupt:
+        return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""Receive a replay capture (Core/Inc/Telemetry/ReplayCapture.hpp) and write it as a stream file.
+
+Datagram (little endian):
+    header: uint16 id (0xFFFC) | uint16 record_count | uint32 sequence | uint32 dropped
+            | stream header
+    stream header: uint32 magic | uint8 version | uint8 lpu_count | uint8 vbat_count
+            | uint8 shunt_count | uint8 airgap_count | uint8 reserved | uint16 frame_size
+    record: uint8 type | uint8 reserved | uint16 size | uint32 tick | payload[size]
+
+The stream file is the stream header followed by the records; where datagrams or
+records were lost a GAP record (type 0xFF, payload uint32 lost_datagrams | uint32
+dropped_records) is written, so host/replay/lcu_replay can tell. Replay it with:
+    out/build/simulator/host/lcu_replay capture-5dof.lcur
+"""
+from __future__ import annotations
+
+import argparse
+import socket
+import struct
+import sys
+import time
+from pathlib import Path
+
+
+CAPTURE_ID = 0xFFFC
+MAGIC = 0x5243554C
+VERSION = 1
+GAP = 0xFF
+
+DATAGRAM_HEADER = struct.Struct("<HHII")
+STREAM_HEADER = struct.Struct("<IBBBBBBH")
+RECORD_HEADER = struct.Struct("<BBHI")
+GAP_PAYLOAD = struct.Struct("<II")
+
+
+def decode_datagram(datagram: bytes):
+    """Return (header fields, raw stream header, list of (type, tick, record bytes))."""
+    prefix = DATAGRAM_HEADER.size + STREAM_HEADER.size
+    if len(datagram) < prefix:
+        raise ValueError(f"Datagram too short: {len(datagram)} bytes")
+    capture_id, record_count, sequence, dropped = DATAGRAM_HEADER.unpack_from(datagram)
+    if capture_id != CAPTURE_ID:
+        raise ValueError(f"Not a capture datagram (id 0x{capture_id:04x})")
+    stream = datagram[DATAGRAM_HEADER.size:prefix]
+    magic, version, *_ = STREAM_HEADER.unpack(stream)
+    if magic != MAGIC or version != VERSION:
+        raise ValueError(f"Unsupported stream (magic 0x{magic:08x}, version {version})")
+
+    records = []
+    offset = prefix
+    for _ in range(record_count):
+        if offset + RECORD_HEADER.size > len(datagram):
+            raise ValueError("Truncated datagram")
+        record_type, _, size, tick = RECORD_HEADER.unpack_from(datagram, offset)
+        end = offset + RECORD_HEADER.size + size
+        if end > len(datagram):
+            raise ValueError("Truncated record")
+        records.append((record_type, tick, datagram[offset:end]))
+        offset = end
+
+    header = {"sequence": sequence, "dropped": dropped}
+    return header, stream, records
+
+
+def gap_record(tick: int, lost_datagrams: int, dropped_records: int) -> bytes:
+    payload = GAP_PAYLOAD.pack(lost_datagrams, dropped_records)
+    return RECORD_HEADER.pack(GAP, 0, len(payload), tick) + payload
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--port", type=int, default=50402, help="UDP port (REPLAY_CAPTURE_PORT)")
+    parser.add_argument("--bind", default="0.0.0.0")
+    parser.add_argument("--output", type=Path, required=True, help="Stream file to write (.lcur)")
+    parser.add_argument(
+        "--duration", type=float, default=0.0, help="Stop after this many seconds (0 = until Ctrl+C)"
+    )
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 8 * 1024 * 1024)
+    sock.bind((args.bind, args.port))
+    sock.settimeout(0.5)
+
+    written = 0
+    lost_datagrams = 0
+    expected_sequence = None
+    first_sequence = None
+    first_dropped = 0
+    last_dropped = 0
+    last_tick = 0
+    stream_header = None
+    deadline = time.monotonic() + args.duration if args.duration > 0 else None
+    with args.output.open("wb") as output:
+        try:
+            while deadline is None or time.monotonic() < deadline:
+                try:
+                    datagram, _ = sock.recvfrom(65535)
+                except socket.timeout:
+                    continue
+                try:
+                    header, stream, records = decode_datagram(datagram)
+                except ValueError as error:
+                    print(f"Skipping datagram: {error}", file=sys.stderr)
+                    continue
+
+                if stream_header is None:
+                    stream_header = stream
+                    output.write(stream)
+                    first_sequence = header["sequence"]
+                    first_dropped = header["dropped"]
+                    last_dropped = header["dropped"]
+                elif stream != stream_header:
+                    print("Board changed its stream layout (rebooted?); stopping", file=sys.stderr)
+                    break
+
+                lost = 0
+                if expected_sequence is not None and header["sequence"] != expected_sequence:
+                    lost = (header["sequence"] - expected_sequence) & 0xFFFFFFFF
+                dropped = header["dropped"] - last_dropped
+                if lost or dropped:
+                    output.write(gap_record(last_tick, lost, dropped))
+                lost_datagrams += lost
+                expected_sequence = (header["sequence"] + 1) & 0xFFFFFFFF
+                last_dropped = header["dropped"]
+
+                for _, tick, record in records:
+                    output.write(record)
+                    last_tick = tick
+                written += len(records)
+        except KeyboardInterrupt:
+            pass
+
+    print(
+        f"{written} records written to {args.output}, "
+        f"{lost_datagrams} datagrams lost on the network, "
+        f"{last_dropped - first_dropped} records dropped on the board"
+    )
+    if first_sequence is not None:
+        if first_sequence == 0 and first_dropped == 0:
+            print("Capture is complete from boot")
+        else:
+            print(
+                "Capture does not start at boot "
+                f"(first datagram {first_sequence}, {first_dropped} records dropped before it); "
+                "the replay starts from the boot state anyway"
+            )
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
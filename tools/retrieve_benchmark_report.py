@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+"""Read the on-target benchmark report (Core/Src/Examples/ExampleBenchmark.cpp) and print it.
+
+Report layout (little endian):
+    header: uint32 magic | uint16 version | uint16 entry_size | uint16 entry_count
+            | uint16 capacity | uint32 core_clock_hz | uint32 flags
+            | uint32 overhead_cycles | uint32 complete | uint32 reserved
+    entry:  char name[24] | uint32 cache | uint32 iterations | uint32 min_cycles
+            | uint32 max_cycles | uint32 mean_cycles
+Over UDP the report follows a 4-byte prefix (uint16 id 0xFFFD, 2 bytes padding).
+"""
+from __future__ import annotations
+
+import argparse
+import json
+import socket
+import struct
+import subprocess
+import sys
+from pathlib import Path
+
+
+MAGIC = 0x48434E42
+VERSION = 1
+REPORT_ID = 0xFFFD
+DUMP_FILE = Path("benchmark_report.bin")
+
+HEADER = struct.Struct("<IHHHHIIIII")
+ENTRY = struct.Struct("<24sIIIII")
+
+FLAGS = {0: "USE_TCM", 1: "USE_5_DOF"}
+FLAG_TRUNCATED = 1 << 2
+
+
+def programmer(*arguments: str) -> None:
+    result = subprocess.run(
+        ["STM32_Programmer_CLI", "-c", "port=swd", "mode=hotplug", "Freq=4000", *arguments],
+        check=False,
+    )
+    if result.returncode != 0:
+        raise RuntimeError(
+            "Error running STM32_Programmer_CLI. Ensure board power, cable and ST-LINK availability."
+        )
+
+
+def report_address(elf: Path) -> int:
+    """Resolve benchmark_report from the firmware ELF."""
+    result = subprocess.run(
+        ["arm-none-eabi-nm", str(elf)], check=True, capture_output=True, text=True
+    )
+    for line in result.stdout.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[2] == "benchmark_report":
+            return int(fields[0], 16)
+    raise RuntimeError(f"benchmark_report not found in {elf}; is it an EXAMPLE_BENCHMARK build?")
+
+
+def dump(address: int, size: int) -> bytes:
+    if DUMP_FILE.exists():
+        DUMP_FILE.unlink()
+    programmer("-u", f"0x{address:08X}", f"0x{size:X}", str(DUMP_FILE))
+    return DUMP_FILE.read_bytes()
+
+
+def read_swd(address: int) -> bytes:
+    """Read the header, then the whole report as sized by its capacity field."""
+    header = dump(address, HEADER.size)
+    if len(header) < HEADER.size or HEADER.unpack_from(header)[0] != MAGIC:
+        return header
+    capacity = HEADER.unpack_from(header)[4]
+    return dump(address, HEADER.size + capacity * ENTRY.size)
+
+
+def read_udp(port: int, bind: str, timeout: float) -> bytes:
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as sock:
+        sock.bind((bind, port))
+        sock.settimeout(timeout)
+        while True:
+            try:
+                data, _ = sock.recvfrom(4096)
+            except socket.timeout as error:
+                raise RuntimeError(f"No report received on UDP port {port}") from error
+            if len(data) > 4 and struct.unpack_from("<H", data)[0] == REPORT_ID:
+                return data[4:]
+
+
+def decode(raw: bytes):
+    """Return (header dict, entries)."""
+    if len(raw) < HEADER.size:
+        raise ValueError(f"Report too short: {len(raw)} bytes")
+    (magic, version, entry_size, entry_count, capacity, clock, flags, overhead, complete, _) = (
+        HEADER.unpack_from(raw)
+    )
+    if magic != MAGIC:
+        raise ValueError(f"No benchmark report (magic 0x{magic:08x})")
+    if version != VERSION or entry_size != ENTRY.size:
+        raise ValueError(f"Unsupported layout: version {version}, entry size {entry_size}")
+    if entry_count > capacity or HEADER.size + entry_count * ENTRY.size > len(raw):
+        raise ValueError("Report shorter than its entry count")
+
+    entries = []
+    for n in range(entry_count):
+        name, cache, iterations, min_cycles, max_cycles, mean_cycles = ENTRY.unpack_from(
+            raw, HEADER.size + n * ENTRY.size
+        )
+        entries.append(
+            {
+                "name": name.split(b"\0", 1)[0].decode(),
+                "cache": bool(cache),
+                "iterations": iterations,
+                "min_cycles": min_cycles,
+                "max_cycles": max_cycles,
+                "mean_cycles": mean_cycles,
+            }
+        )
+
+    header = {
+        "core_clock_hz": clock,
+        "flags": [name for bit, name in FLAGS.items() if flags & (1 << bit)],
+        "overhead_cycles": overhead,
+        "complete": bool(complete),
+        "truncated": bool(flags & FLAG_TRUNCATED),
+    }
+    return header, entries
+
+
+def print_report(header, entries) -> None:
+    clock_mhz = header["core_clock_hz"] / 1e6 if header["core_clock_hz"] else None
+    flags = ", ".join(header["flags"]) or "none"
+    print(
+        f"Core clock {clock_mhz or '?'} MHz, flags: {flags}, "
+        f"overhead {header['overhead_cycles']} cycles"
+    )
+    if not header["complete"]:
+        print("Report incomplete: the suite is still running or did not finish")
+    if header["truncated"]:
+        print(f"Report truncated: only the first {len(entries)} measurements fit")
+
+    by_cache = {(entry["name"], entry["cache"]): entry for entry in entries}
+    names = list(dict.fromkeys(entry["name"] for entry in entries))
+    print(
+        f"{'benchmark':<24} {'cache on min/mean/max':>24} "
+        f"{'cache off min/mean/max':>24} {'on us':>8}"
+    )
+    for name in names:
+        cells = []
+        for cache in (True, False):
+            entry = by_cache.get((name, cache))
+            if entry:
+                cells.append(f"{entry['min_cycles']}/{entry['mean_cycles']}/{entry['max_cycles']}")
+            else:
+                cells.append("-")
+        on = by_cache.get((name, True))
+        us = f"{on['mean_cycles'] / clock_mhz:.3f}" if on and clock_mhz else "-"
+        print(f"{name:<24} {cells[0]:>24} {cells[1]:>24} {us:>8}")
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--elf", type=Path, help="Firmware ELF, used to find benchmark_report")
+    source.add_argument("--address", type=lambda text: int(text, 0), help="Report address")
+    source.add_argument("--file", type=Path, help="Decode an existing dump instead of reading SWD")
+    source.add_argument("--udp", type=int, metavar="PORT", help="Wait for the report on this port")
+    parser.add_argument("--bind", default="0.0.0.0", help="Address to bind with --udp")
+    parser.add_argument("--timeout", type=float, default=5.0, help="Seconds to wait with --udp")
+    parser.add_argument("--json", type=Path, help="Write header and entries as JSON")
+    args = parser.parse_args()
+
+    try:
+        if args.file:
+            raw = args.file.read_bytes()
+        elif args.udp is not None:
+            raw = read_udp(args.udp, args.bind, args.timeout)
+        else:
+            address = args.address if args.address is not None else report_address(args.elf)
+            raw = read_swd(address)
+        header, entries = decode(raw)
+    except (RuntimeError, ValueError, OSError, subprocess.CalledProcessError) as error:
+        print(error, file=sys.stderr)
+        return 1
+
+    print_report(header, entries)
+    if args.json:
+        args.json.write_text(json.dumps({"header": header, "entries": entries}, indent=2))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
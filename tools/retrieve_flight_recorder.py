@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+"""Read the flight recorder (Core/Inc/Telemetry/FlightRecorder.hpp) through SWD and decode it.
+
+Region layout (little endian):
+    header: uint32 magic | uint16 version | uint16 record_size | uint32 capacity
+            | uint32 write_count | uint32 frozen | uint32 freeze_reason
+            | uint32 freeze_cycles | uint32 resets_since_freeze
+    record: uint32 cycles | uint32 tick | uint8 type | uint8 state | uint16 flags | float values[4]
+"""
+from __future__ import annotations
+
+import argparse
+import csv
+import json
+import struct
+import subprocess
+import sys
+from pathlib import Path
+
+
+MAGIC = 0x43455246
+VERSION = 1
+REGION_SIZE = 16 * 1024
+DUMP_FILE = Path("flight_recorder.bin")
+
+HEADER = struct.Struct("<IHHIIIIII")
+RECORD = struct.Struct("<IIBBH4f")
+
+RECORD_TYPES = {1: "SAMPLE", 2: "TRANSITION", 3: "FREEZE"}
+FREEZE_REASONS = {0: "NONE", 1: "FAULT_STATE", 2: "HARD_FAULT"}
+# LCU_SM::OperationalState
+STATES = {0: "SPI_CONNECTING", 1: "IDLE", 2: "CURRENT_CONTROL", 3: "LEVITATING", 4: "FAULT"}
+
+SAMPLE_COLUMNS = ["target_voltage", "lpu0_current", "lpu0_duty", "airgap0"]
+
+
+def programmer(*arguments: str) -> None:
+    result = subprocess.run(
+        ["STM32_Programmer_CLI", "-c", "port=swd", "mode=hotplug", "Freq=4000", *arguments],
+        check=False,
+    )
+    if result.returncode != 0:
+        raise RuntimeError(
+            "Error running STM32_Programmer_CLI. Ensure board power, cable and ST-LINK availability."
+        )
+
+
+def region_address(elf: Path) -> int:
+    """Resolve _sflight_recorder from the firmware ELF."""
+    result = subprocess.run(
+        ["arm-none-eabi-nm", str(elf)], check=True, capture_output=True, text=True
+    )
+    for line in result.stdout.splitlines():
+        fields = line.split()
+        if len(fields) == 3 and fields[2] == "_sflight_recorder":
+            return int(fields[0], 16)
+    raise RuntimeError(f"_sflight_recorder not found in {elf}; is RECORDER_placement.ld linked?")
+
+
+def read_region(address: int) -> bytes:
+    if DUMP_FILE.exists():
+        DUMP_FILE.unlink()
+    programmer("-u", f"0x{address:08X}", f"0x{REGION_SIZE:X}", str(DUMP_FILE))
+    return DUMP_FILE.read_bytes()
+
+
+def decode(raw: bytes):
+    """Return (header dict, records in chronological order)."""
+    if len(raw) < HEADER.size:
+        raise ValueError(f"Dump too short: {len(raw)} bytes")
+    magic, version, record_size, capacity, write_count, frozen, reason, freeze_cycles, resets = (
+        HEADER.unpack_from(raw)
+    )
+    if magic != MAGIC:
+        raise ValueError(f"No flight recorder log (magic 0x{magic:08x})")
+    if version != VERSION or record_size != RECORD.size:
+        raise ValueError(f"Unsupported layout: version {version}, record size {record_size}")
+    if HEADER.size + capacity * RECORD.size > len(raw):
+        raise ValueError("Dump shorter than the recorded capacity")
+
+    count = min(write_count, capacity)
+    first = write_count - count
+    records = []
+    for n in range(first, write_count):
+        cycles, tick, kind, state, flags, *values = RECORD.unpack_from(
+            raw, HEADER.size + (n % capacity) * RECORD.size
+        )
+        records.append(
+            {
+                "index": n,
+                "cycles": cycles,
+                "tick": tick,
+                "type": RECORD_TYPES.get(kind, str(kind)),
+                "state": STATES.get(state, str(state)),
+                "flags": flags,
+                "values": values,
+            }
+        )
+
+    header = {
+        "frozen": bool(frozen),
+        "freeze_reason": FREEZE_REASONS.get(reason, str(reason)),
+        "freeze_cycles": freeze_cycles,
+        "resets_since_freeze": resets,
+        "write_count": write_count,
+        "capacity": capacity,
+        "lost_records": first,
+    }
+    return header, records
+
+
+def write_csv(path: Path, records) -> None:
+    with path.open("w", newline="") as output:
+        writer = csv.writer(output)
+        writer.writerow(["index", "cycles", "tick", "type", "state", "flags", *SAMPLE_COLUMNS])
+        for record in records:
+            values = record["values"]
+            if record["type"] == "TRANSITION":
+                values = [STATES.get(int(values[0]), values[0]), "", "", ""]
+            elif record["type"] == "FREEZE":
+                values = [FREEZE_REASONS.get(int(values[0]), values[0]), "", "", ""]
+            writer.writerow(
+                [
+                    record["index"],
+                    record["cycles"],
+                    record["tick"],
+                    record["type"],
+                    record["state"],
+                    f"0x{record['flags']:04x}",
+                    *values,
+                ]
+            )
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--elf", type=Path, help="Firmware ELF, used to find _sflight_recorder")
+    source.add_argument("--address", type=lambda text: int(text, 0), help="Region base address")
+    source.add_argument("--file", type=Path, help="Decode an existing dump instead of reading SWD")
+    parser.add_argument("--csv", type=Path, help="Write the records as CSV")
+    parser.add_argument("--json", type=Path, help="Write header and records as JSON")
+    parser.add_argument(
+        "--clear", action="store_true", help="Invalidate the log after reading it (re-arms recording)"
+    )
+    args = parser.parse_args()
+
+    try:
+        if args.file:
+            raw = args.file.read_bytes()
+            address = None
+        else:
+            address = args.address if args.address is not None else region_address(args.elf)
+            raw = read_region(address)
+        header, records = decode(raw)
+    except (RuntimeError, ValueError, OSError, subprocess.CalledProcessError) as error:
+        print(error, file=sys.stderr)
+        return 1
+
+    state = f"frozen ({header['freeze_reason']})" if header["frozen"] else "recording"
+    print(
+        f"Flight recorder {state}: {len(records)} records "
+        f"({header['lost_records']} overwritten), {header['resets_since_freeze']} resets since freeze"
+    )
+    for record in records:
+        if record["type"] != "SAMPLE":
+            print(f"  #{record['index']} tick {record['tick']} {record['type']} -> {record['state']}")
+
+    if args.csv:
+        write_csv(args.csv, records)
+    if args.json:
+        args.json.write_text(json.dumps({"header": header, "records": records}, indent=2))
+
+    if args.clear:
+        if address is None:
+            print("--clear needs --elf or --address", file=sys.stderr)
+            return 1
+        # Zeroing the magic makes FlightRecorder::init() start a fresh log on the next boot
+        programmer("-w32", f"0x{address:08X}", "0x00000000")
+        print("Log cleared; recording restarts after the next reset")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())